@@ -11,57 +11,68 @@
 #include <string.h>
 
 #include "linkedlist.h"
+#include "packed.h"
+#include "topk.h"
+
+// most households the top households option displays
+#define TOPK_MAX_DISPLAY 1000
 
 /**
  * Generate a random number that represents a regions name.
  *
+ * @param rng random number generator
  * @return region number
  */
-int generateRegion() {
+int generateRegion(random_context *rng) {
   // get random number for region
-  return rand() % (REGION_RANGE + 1) + REGION_OFFSET;
+  return (int)boundedRandom(rng, REGION_RANGE + 1) + REGION_OFFSET;
 }
 
 /**
  * Generate a random number that represents a town's name
  *
+ * @param rng random number generator
  * @return town number
  */
-int generateTown() {
+int generateTown(random_context *rng) {
   // get random number for the town
-  return rand() % (TOWN_RANGE + 1) + TOWN_OFFSET;
+  return (int)boundedRandom(rng, TOWN_RANGE + 1) + TOWN_OFFSET;
 }
 
 /**
  * Generate a random number that represents a defined race (0 - 4)
  *
+ * @param rng random number generator
  * @return a number representing a race
  */
-int generateRace() {
+int generateRace(random_context *rng) {
   // get random number for the race
-  return rand() % (RACE_RANGE + 1) + RACE_OFFSET;
+  return (int)boundedRandom(rng, RACE_RANGE + 1) + RACE_OFFSET;
 }
 
 /**
  * Generate a random number to represent a household size between 1 and 20
  *
+ * @param rng random number generator
  * @return household size
  */
-int generateHouseholdSize() {
+int generateHouseholdSize(random_context *rng) {
   // get random number for the household size
-  return rand() % (HOUSEHOLD_SIZE_RANGE) + HOUSEHOLD_SIZE_OFFSET;
+  return (int)boundedRandom(rng, HOUSEHOLD_SIZE_RANGE) + HOUSEHOLD_SIZE_OFFSET;
 }
 
 /**
  * Generate a random number of senior citizens living in a given household
  *
+ * @param rng random number generator
  * @param household_size
  * @return
  */
-int generateSeniors(int household_size) {
+int generateSeniors(random_context *rng, int household_size) {
   // get a random number for the number of seniors (aged above 50) in the
   // household
-  return rand() % household_size + HOUSEHOLD_SIZE_OFFSET;
+  return (int)boundedRandom(rng, (uint32_t)household_size) +
+         HOUSEHOLD_SIZE_OFFSET;
 }
 
 /**
@@ -81,25 +92,30 @@ int numberOfAdults(int household_size, int seniors) {
  * Generate a random number of adults (not seniors [over 50]) that have chronic
  * diseases.
  *
+ * @param rng random number generator
  * @param adults
  * @return number of adults who have chronic diseases
  */
-int generateAdultsWithChronicDiseases(int adults) {
+int generateAdultsWithChronicDiseases(random_context *rng, int adults) {
   // get a random number for adults with chronic diseases in the household. if
   // adults is 0, return 0
-  return (adults > 0) ? rand() % adults + HOUSEHOLD_SIZE_OFFSET : 0;
+  return (adults > 0)
+             ? (int)boundedRandom(rng, (uint32_t)adults) + HOUSEHOLD_SIZE_OFFSET
+             : 0;
 }
 
 /**
  * Generate a random number of people tested for covid based on the number of
  * people living in the household.
  *
+ * @param rng random number generator
  * @param household_size
  * @return number of people tested for covid
  */
-int generateTested(int household_size) {
+int generateTested(random_context *rng, int household_size) {
   // get a random number for the number of people tested in the household
-  return rand() % household_size + HOUSEHOLD_SIZE_OFFSET;
+  return (int)boundedRandom(rng, (uint32_t)household_size) +
+         HOUSEHOLD_SIZE_OFFSET;
 }
 
 /**
@@ -107,20 +123,21 @@ int generateTested(int household_size) {
  * between the number of adults that exists and the number of people tested for
  * covid.
  *
+ * @param rng random number generator
  * @param adults
  * @param tested
  * @return random number of adults tested positive
  */
-int generateAdultsTestedPositive(int adults, int tested) {
+int generateAdultsTestedPositive(random_context *rng, int adults, int tested) {
   int adultsTestedPositive = 0;
   // get a random number for the adults tested positive in the household
   if (adults) {
     // limit on adults
     if (adults < tested)
-      adultsTestedPositive = rand() % adults + 1;
+      adultsTestedPositive = (int)boundedRandom(rng, (uint32_t)adults) + 1;
     // limit on tested
     else
-      adultsTestedPositive = rand() % tested + 1;
+      adultsTestedPositive = (int)boundedRandom(rng, (uint32_t)tested) + 1;
   }
   return adultsTestedPositive;
 }
@@ -128,28 +145,95 @@ int generateAdultsTestedPositive(int adults, int tested) {
 /**
  * Generate a household item
  *
+ * @param rng random number generator
  * @return a household item
  */
-household generateHousehold() {
+household generateHousehold(random_context *rng) {
   // create new household item -- use the aforementioned methods to create a new
   // household item
   household item;
-  item.region = generateRegion();
-  item.town = generateTown();
-  item.race = generateRace();
-  item.size = generateHouseholdSize();
-  item.seniors = generateSeniors(item.size);
-  item.tested = generateTested(item.size);
+  item.region = generateRegion(rng);
+  item.town = generateTown(rng);
+  item.race = generateRace(rng);
+  item.size = generateHouseholdSize(rng);
+  item.seniors = generateSeniors(rng, item.size);
+  item.tested = generateTested(rng, item.size);
 
   int adults = numberOfAdults(item.size, item.seniors);
 
-  item.adultsWithChronicDiseases = generateAdultsWithChronicDiseases(adults);
-  item.adultsTestedPositive = generateAdultsTestedPositive(adults, item.tested);
+  item.adultsWithChronicDiseases =
+      generateAdultsWithChronicDiseases(rng, adults);
+  item.adultsTestedPositive =
+      generateAdultsTestedPositive(rng, adults, item.tested);
 
   // return the newly created household item
   return item;
 }
 
+/**
+ * Generate a batch of household items in one call. The random numbers come
+ * from RANDOM_LANES generators stepped together, and every field is drawn
+ * without branches, keeping the same ranges as generateHousehold: seniors and
+ * tested between 1 and the household size, and adults with chronic diseases
+ * and adults tested positive at 0 when there are no adults.
+ *
+ * @param rng random number generator, seeds the lanes of the batch
+ * @param count number of households to generate
+ * @param out where to write the households
+ */
+void generateHouseholdsBatch(random_context *rng, long count, household *out) {
+  random_lanes lanes;
+  uint64_t bits[4][RANDOM_LANES]; // 8 x 32 random bits for every household
+  long first;
+  int i;
+
+  seedRandomLanes(&lanes, rng);
+  for (first = 0; first < count; first += RANDOM_LANES) {
+    int lanesUsed =
+        count - first < RANDOM_LANES ? (int)(count - first) : RANDOM_LANES;
+    for (i = 0; i < 4; i++)
+      nextRandomLanes(&lanes, bits[i]);
+
+    for (i = 0; i < lanesUsed; i++) {
+      household *item = &out[first + i];
+      int size, seniors, tested, adults, hasAdults, positiveLimit;
+
+      item->region =
+          scaleRandom((uint32_t)bits[0][i], REGION_RANGE + 1) + REGION_OFFSET;
+      item->town =
+          scaleRandom((uint32_t)(bits[0][i] >> 32), TOWN_RANGE + 1) +
+          TOWN_OFFSET;
+      item->race =
+          scaleRandom((uint32_t)bits[1][i], RACE_RANGE + 1) + RACE_OFFSET;
+      size = scaleRandom((uint32_t)(bits[1][i] >> 32), HOUSEHOLD_SIZE_RANGE) +
+             HOUSEHOLD_SIZE_OFFSET;
+      seniors = scaleRandom((uint32_t)bits[2][i], (uint32_t)size) +
+                HOUSEHOLD_SIZE_OFFSET;
+      tested = scaleRandom((uint32_t)(bits[2][i] >> 32), (uint32_t)size) +
+               HOUSEHOLD_SIZE_OFFSET;
+      adults = numberOfAdults(size, seniors);
+
+      // draw as if there was an adult, then mask the result out if there
+      // isn't -- the limit on adults tested positive is adults or tested
+      hasAdults = adults > 0;
+      positiveLimit = adults < tested ? adults : tested;
+      item->size = size;
+      item->seniors = seniors;
+      item->tested = tested;
+      item->adultsWithChronicDiseases =
+          (scaleRandom((uint32_t)bits[3][i],
+                       (uint32_t)(adults + !hasAdults)) +
+           1) &
+          -hasAdults;
+      item->adultsTestedPositive =
+          (scaleRandom((uint32_t)(bits[3][i] >> 32),
+                       (uint32_t)(positiveLimit + !hasAdults)) +
+           1) &
+          -hasAdults;
+    }
+  }
+}
+
 /**
  * Create a specified household with a set of custom (specified) parameters
  *
@@ -216,6 +300,74 @@ void printHouseholdItemSeparator() {
          "-----------------------------------------------\n");
 }
 
+/**
+ * Write the header of a households file, naming the column of every field
+ *
+ * @param file
+ */
+void writeHouseholdHeader(FILE *file) {
+  fprintf(file, "%5s\t%7s\t%16s\t%20s\t%20s\t%10s\t%15s\n", "S.no", "Size",
+          "Total Tested", "Total Tested Positive", "Race", "Region", "Town");
+}
+
+/**
+ * Write a single household to a households file, matching the header
+ *
+ * @param file
+ * @param ctr number of the record in the file
+ * @param item
+ */
+void writeHouseholdRecord(FILE *file, long ctr, household item) {
+  fprintf(file, "%5ld\t%7d\t%16d\t%20d\t%20s\t%10s\t%15s\n", ctr,
+          item.size, item.tested, item.adultsTestedPositive,
+          displayRace(item.race), displayRegion(item.region),
+          displayTown(item.region, item.town));
+}
+
+/**
+ * Read back a single household of a households file, as written by
+ * writeHouseholdRecord. The file doesn't keep the seniors and adults with
+ * chronic diseases of a household, they are read back as 0.
+ *
+ * @param line of the file
+ * @param item where to store the household
+ * @return 1 if the line is a household, 0 otherwise
+ */
+int parseHouseholdRecord(const char *line, household *item) {
+  char race[32], region[32], town[32];
+  long ctr;
+  int size, tested, testedPositive, i;
+
+  if (sscanf(line, "%ld %d %d %d %31[^\t] %31[^\t] %31[^\t\r\n]", &ctr,
+             &size, &tested, &testedPositive, race, region, town) != 7 ||
+      size < 0 || tested < 0 || testedPositive < 0)
+    return 0;
+
+  // the names are turned back into numbers by going through every value
+  item->race = item->region = item->town = -1;
+  for (i = 0; i <= RACE_RANGE; i++) {
+    if (strcmp(race, displayRace(i)) == 0)
+      item->race = i;
+  }
+  for (i = 0; i <= REGION_RANGE; i++) {
+    if (strcmp(region, displayRegion(i)) == 0)
+      item->region = i;
+  }
+  for (i = 0; i <= TOWN_RANGE && item->region >= 0; i++) {
+    if (strcmp(town, displayTown(item->region, i)) == 0)
+      item->town = i;
+  }
+  if (item->race < 0 || item->region < 0 || item->town < 0)
+    return 0;
+
+  item->size = size;
+  item->seniors = 0;
+  item->adultsWithChronicDiseases = 0;
+  item->tested = tested;
+  item->adultsTestedPositive = testedPositive;
+  return 1;
+}
+
 /**
  * Print a message after the records of the linked list has been displayed
  */
@@ -369,6 +521,12 @@ void displayMenu() {
   printf("8. display updated data\n");
   printf("9. store data to a file\n");
   printf("10. display data from file\n");
+  printf("11. display the totals of every race within every region\n");
+  printf("12. display households matching a filter expression\n");
+  printf("13. display a report of a region, a race and the region's minimum "
+         "number of people tested positive for COVID-19\n");
+  printf("14. display the households of a region with the most people tested "
+         "positive for COVID-19\n");
   printf("0. to exit the program\n");
   printf("Your choice: ");
 }
@@ -519,10 +677,8 @@ void displayHouseholdsByRace(Node *head) {
 /**
  * Display the households by region with a specified minimum of adults tested
  * positive.
- *
- * @param head of the linked list
  */
-void displayByRegionMinTestedPositive(Node *head) {
+void displayByRegionMinTestedPositive() {
   int regionChoice;
   int minTestedPositive;
   do {
@@ -538,7 +694,7 @@ void displayByRegionMinTestedPositive(Node *head) {
           "%d",
           &minTestedPositive); // get the minimum adults positive from the user
       printLinkedListByRegionWithMinTestedPositive(
-          head, regionChoice,
+          regionChoice,
           minTestedPositive); // print the linked list filtered by the region
                               // and minimum tested positive
       regionChoice = 9;       // ensure that the do - while loop exists
@@ -550,6 +706,92 @@ void displayByRegionMinTestedPositive(Node *head) {
   } while (regionChoice != 9); // loop until region entered is 9
 }
 
+/**
+ * Display the households matching a filter expression entered by the user, for
+ * example region=1 AND race IN (0,3) AND tested>=5
+ *
+ * @param head of the linked list
+ */
+void displayHouseholdsByFilter(Node *head) {
+  char expression[FILTER_MAX_EXPRESSION + 2]; // room for the new line
+  household_filter filter;
+
+  // flush input stream
+  while (getchar() != '\n')
+    ;
+
+  printf("Enter a filter expression over region, town, race, size, seniors, "
+         "chronic, tested and positive, for example:\n");
+  printf("region=1 AND race IN (0,3) AND tested>=5 AND seniors>0\n");
+  printf("Filter: ");
+  if (fgets(expression, sizeof(expression), stdin) == NULL)
+    return;
+  if (strchr(expression, '\n') == NULL) {
+    // too long -- drop the rest of the line, compileFilter refuses it
+    int c;
+    while ((c = getchar()) != '\n' && c != EOF)
+      ;
+  }
+  expression[strcspn(expression, "\n")] = 0;
+
+  // the expression is compiled once, then matched against every household
+  if (!compileFilter(expression, &filter)) {
+    puts("");
+    return;
+  }
+  printLinkedListByFilter(head, &filter);
+}
+
+/**
+ * Display a report -- the households of a region, of a race, and of the region
+ * with a minimum of adults tested positive, followed by the region and town
+ * ranking. The listings are answered by a single scan of the linked list.
+ *
+ * @param head of the linked list
+ */
+void displayReport(Node *head) {
+  int regionChoice = getRegionInput();
+  int raceChoice = getRaceInput();
+  int minTestedPositive;
+
+  printf("Enter minimum number of people tested positive\n");
+  scanf("%d", &minTestedPositive);
+  printLinkedListReport(head, regionChoice, raceChoice, minTestedPositive);
+
+  // the rankings are grouped from the data cube, no scan is needed
+  printf("Tested Positive for COVID-19 cases:\n");
+  displayRegionAndTownRankingTestedPositive(head);
+}
+
+/**
+ * Display the K households of a region with the most adults tested positive,
+ * or with the highest share of the tested adults positive
+ */
+void displayTopHouseholdsByRegion() {
+  int regionChoice = getRegionInput();
+  int orderChoice;
+  long k;
+
+  do {
+    printf("Enter an integer for the ranking: most people tested positive (0) "
+           "highest share of people tested positive (1)\n");
+    scanf("%d", &orderChoice);
+    if (orderChoice != TOPK_POSITIVE && orderChoice != TOPK_RATIO)
+      printf("Invalid input. Try again.\n");
+  } while (orderChoice != TOPK_POSITIVE && orderChoice != TOPK_RATIO);
+
+  do {
+    printf("Enter the number of households to display\n");
+    scanf("%ld", &k);
+    if (k < 1 || k > TOPK_MAX_DISPLAY)
+      printf("Invalid input. Enter 1 through %d. Try again.\n",
+             TOPK_MAX_DISPLAY);
+  } while (k < 1 || k > TOPK_MAX_DISPLAY);
+
+  printf("Top records with region: %s.\n", displayRegion(regionChoice));
+  printLinkedListTopByRegion(regionChoice, orderChoice, k);
+}
+
 /**
  * Display the region and town ranking based on adults tested positive
  *
@@ -604,7 +846,7 @@ void printCaseRanking(rank_cases *region, int count) {
   int i;
   // loop through the specified number of times and print the cases
   for (i = 0; i < count; i++) {
-    printf("%15s : %5d\n", region[i].name, region[i].cases);
+    printf("%15s : %5ld\n", region[i].name, region[i].cases);
   }
 }
 
@@ -708,6 +950,12 @@ void getHouseholdInformationInput(int *householdSize, int *householdSeniors,
     // check if the household size is 0 or lower
     else if (size <= 0)
       printf("The household size cannot be zero. Try again.\n");
+    // check that every number fits the packed household of the linked list
+    else if (size > PACKED_MEASURE_MAX || seniors < 0 ||
+             adultsWithChronicDiseases < 0)
+      printf("The household can't have more than %d people or a negative "
+             "number of people. Try again.\n",
+             PACKED_MEASURE_MAX);
     // everything is fine
     else
       validInput = 1;
@@ -739,6 +987,10 @@ int getHouseholdCovidInformationInput(int householdSize, int *householdTested,
            "COVID-19 and those who were tested positive separated by space or "
            "tab.\n");
     scanf("%d %d", &tested, &testedPositive);
+    if (tested < 0 || testedPositive < 0) {
+      printf("The people tested cannot be negative. Try again.\n");
+      continue;
+    }
     // check to see if the tested are greater than the household size or if the
     // tested positive is greater than the tested
     if (tested > householdSize || testedPositive > tested) {
@@ -799,7 +1051,10 @@ Node *addRecord(Node *head) {
       createHousehold(region, town, race, size, seniors,
                       adultsWithChronicDiseases, tested, testedPositive);
   // add the record
-  addNode(&head, item);
+  if (!addNode(&head, item)) {
+    printf("Not enough memory to add the household.\n\n");
+    return head;
+  }
   // print new household item
   printHouseholdItemHeader();
   printHouseholdItem(1, item);
@@ -818,6 +1073,10 @@ Node *deleteByRegionTownRace(Node *head) {
   int town = getTownInput(region);
   int race = getRaceInput();
 
+  // list the households of the triplet, found through the triplet index,
+  // before they are deleted
+  printLinkedListByRegionTownRace(head, region, town, race);
+
   // send the request to delete the household record based on the region, town
   // and race
   deleteLinkedListItem(&head, region, town, race);
@@ -9,6 +9,11 @@
 #ifndef ELMERALMEIDAASSIGN3_ALMEIELM_H
 #define ELMERALMEIDAASSIGN3_ALMEIELM_H
 
+#include <stdint.h>
+#include <stdio.h>
+
+#include "random.h"
+
 #define NUM_REGIONS 3
 #define NUM_TOWNS 6
 
@@ -35,31 +40,38 @@ typedef struct Household {
   int adultsTestedPositive;
 } household;
 
+// a household packed into a single 64-bit word, see packed.h
+typedef uint64_t packed_household;
+
 typedef struct node {
-  household item;
+  packed_household packed; // household of the node, see getNodeHousehold
   struct node *next;
+  struct node *prev;        // previous node, to unlink a node in place
+  struct node *tripletNext; // next node with the same region, town and race
+  long id; // slot of the node in the node pool, reused once the node is freed
 } Node, *NodePtr;
 
 typedef struct rank_cases {
   char *name;
-  int cases;
+  long cases;
 } rank_cases;
 
-int generateRegion();
-int generateTown();
-int generateRace();
-int generateHouseholdSize();
-int generateSeniors(int household_size);
+int generateRegion(random_context *rng);
+int generateTown(random_context *rng);
+int generateRace(random_context *rng);
+int generateHouseholdSize(random_context *rng);
+int generateSeniors(random_context *rng, int household_size);
 int numberOfAdults(int household_size, int seniors);
-int generateAdultsWithChronicDiseases(int adults);
-int generateTested(int household_size);
-int generateAdultsTestedPositive(int adults, int tested);
+int generateAdultsWithChronicDiseases(random_context *rng, int adults);
+int generateTested(random_context *rng, int household_size);
+int generateAdultsTestedPositive(random_context *rng, int adults, int tested);
 
 char *displayRegion(int region);
 char *displayTown(int region, int town);
 char *displayRace(int race);
 
-household generateHousehold();
+household generateHousehold(random_context *rng);
+void generateHouseholdsBatch(random_context *rng, long count, household *out);
 household createHousehold(int region, int town, int race, int size, int seniors,
                           int adultsWithChronicDiseases, int tested,
                           int testedPositive);
@@ -67,12 +79,18 @@ void printHouseholdItemHeader();
 void printHouseholdItem(int ctr, household household);
 void printHouseholdItemSeparator();
 void printHouseholdItemFooter();
+void writeHouseholdHeader(FILE *file);
+void writeHouseholdRecord(FILE *file, long ctr, household item);
+int parseHouseholdRecord(const char *line, household *item);
 
 void displayMenu();
 void displayHouseholdsByRegion(Node *head);
 void displayHouseholdsByTown(Node *head);
 void displayHouseholdsByRace(Node *head);
-void displayByRegionMinTestedPositive(Node *head);
+void displayByRegionMinTestedPositive();
+void displayHouseholdsByFilter(Node *head);
+void displayReport(Node *head);
+void displayTopHouseholdsByRegion();
 
 void displayRegionAndTownRankingTestedPositive(Node *head);
 void sortCaseRanking(rank_cases *item, int count);
@@ -0,0 +1,210 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the bitmap indexes defined in
+ * bitmapindex.h
+ */
+
+#include "bitmapindex.h"
+#include "packed.h"
+#include "roaring.h"
+#include "scan.h"
+
+#define NUM_TOWNS_PER_REGION (TOWN_RANGE + 1)
+#define NUM_RACES (RACE_RANGE + 1)
+
+// node ids of the households of every region, town and race
+static roaring_bitmap regionBitmaps[NUM_REGIONS];
+static roaring_bitmap townBitmaps[NUM_REGIONS][NUM_TOWNS_PER_REGION];
+static roaring_bitmap raceBitmaps[NUM_RACES];
+// set once a bitmap ran out of memory -- the bitmaps are dropped and the
+// counts scan the list until the whole list is released
+static int bitmapsStale = 0;
+
+/**
+ * Free every bitmap
+ */
+static void freeBitmaps() {
+  int region, town, race;
+  for (region = 0; region < NUM_REGIONS; region++) {
+    freeRoaring(&regionBitmaps[region]);
+    for (town = 0; town < NUM_TOWNS_PER_REGION; town++)
+      freeRoaring(&townBitmaps[region][town]);
+  }
+  for (race = 0; race < NUM_RACES; race++)
+    freeRoaring(&raceBitmaps[race]);
+}
+
+/**
+ * Add a node id to the bitmaps of its region, town and race -- called for
+ * every node added to the linked list. If a bitmap runs out of memory, the
+ * bitmaps no longer match the list: they are dropped, and the counts scan the
+ * list instead.
+ *
+ * @param node
+ */
+void indexBitmapNode(Node *node) {
+  household item = getNodeHousehold(node);
+  int region = item.region, town = item.town, race = item.race, added = 1;
+  uint32_t id = (uint32_t)node->id;
+
+  if (bitmapsStale)
+    return;
+  // households with an unknown region, town or race are left out
+  if (region >= 0 && region < NUM_REGIONS) {
+    added &= addRoaring(&regionBitmaps[region], id);
+    if (town >= 0 && town < NUM_TOWNS_PER_REGION)
+      added &= addRoaring(&townBitmaps[region][town], id);
+  }
+  if (race >= 0 && race < NUM_RACES)
+    added &= addRoaring(&raceBitmaps[race], id);
+
+  if (!added) {
+    freeBitmaps();
+    bitmapsStale = 1;
+  }
+}
+
+/**
+ * Remove a node id from the bitmaps -- called for every node deleted from the
+ * linked list, before the id can be handed out again.
+ *
+ * @param node
+ */
+void unindexBitmapNode(Node *node) {
+  household item = getNodeHousehold(node);
+  int region = item.region, town = item.town, race = item.race;
+  uint32_t id = (uint32_t)node->id;
+
+  if (bitmapsStale)
+    return;
+  if (region >= 0 && region < NUM_REGIONS) {
+    removeRoaring(&regionBitmaps[region], id);
+    if (town >= 0 && town < NUM_TOWNS_PER_REGION)
+      removeRoaring(&townBitmaps[region][town], id);
+  }
+  if (race >= 0 && race < NUM_RACES)
+    removeRoaring(&raceBitmaps[race], id);
+}
+
+/**
+ * Empty every bitmap -- called when the whole list is released. The empty
+ * bitmaps match the empty list again.
+ */
+void clearBitmapIndex() {
+  freeBitmaps();
+  bitmapsStale = 0;
+}
+
+/**
+ * Count the households of the linked list matching a region, town and race,
+ * for the counts asked once the bitmaps have been dropped
+ *
+ * @param region SCAN_ANY for every region
+ * @param town SCAN_ANY for every town
+ * @param race SCAN_ANY for every race
+ * @return number of households
+ */
+static long scanHouseholds(int region, int town, int race) {
+  household_predicate predicate = anyHousehold();
+  predicate.region = region;
+  predicate.town = town;
+  predicate.race = race;
+  return countLinkedList(&predicate);
+}
+
+/**
+ * Get the number of households of a region
+ *
+ * @param region
+ * @return number of households
+ */
+long countHouseholdsByRegion(int region) {
+  if (region < 0 || region >= NUM_REGIONS)
+    return 0;
+  if (bitmapsStale)
+    return scanHouseholds(region, SCAN_ANY, SCAN_ANY);
+  return cardinalityRoaring(&regionBitmaps[region]);
+}
+
+/**
+ * Get the number of households of a town
+ *
+ * @param region
+ * @param town
+ * @return number of households
+ */
+long countHouseholdsByTown(int region, int town) {
+  if (region < 0 || region >= NUM_REGIONS || town < 0 ||
+      town >= NUM_TOWNS_PER_REGION)
+    return 0;
+  if (bitmapsStale)
+    return scanHouseholds(region, town, SCAN_ANY);
+  return cardinalityRoaring(&townBitmaps[region][town]);
+}
+
+/**
+ * Get the number of households of a race
+ *
+ * @param race
+ * @return number of households
+ */
+long countHouseholdsByRace(int race) {
+  if (race < 0 || race >= NUM_RACES)
+    return 0;
+  if (bitmapsStale)
+    return scanHouseholds(SCAN_ANY, SCAN_ANY, race);
+  return cardinalityRoaring(&raceBitmaps[race]);
+}
+
+/**
+ * Get the number of households of a region belonging to any of a set of races.
+ * The race bitmaps are combined with OR, then ANDed with the region bitmap.
+ *
+ * @param region the region, or -1 for every region
+ * @param raceMask bit n set to count race n, ALL_RACES for every race
+ * @return number of households, -1 if out of memory
+ */
+long countHouseholdsByRegionAndRaces(int region, unsigned raceMask) {
+  roaring_bitmap races, merged;
+  long count;
+  int race;
+
+  if (region >= NUM_REGIONS)
+    return 0;
+  if (bitmapsStale) {
+    // a scan per race -- the races of a household don't overlap
+    count = 0;
+    for (race = 0; race < NUM_RACES; race++) {
+      if (raceMask & (1u << race))
+        count += scanHouseholds(region < 0 ? SCAN_ANY : region, SCAN_ANY,
+                                race);
+    }
+    return count;
+  }
+
+  // union of the selected races
+  initRoaring(&races);
+  initRoaring(&merged);
+  for (race = 0; race < NUM_RACES; race++) {
+    if (!(raceMask & (1u << race)))
+      continue;
+    if (!orRoaring(&races, &raceBitmaps[race], &merged)) {
+      freeRoaring(&races);
+      freeRoaring(&merged);
+      return -1;
+    }
+    // the union so far becomes the input of the next OR
+    freeRoaring(&races);
+    races = merged;
+    initRoaring(&merged);
+  }
+
+  if (region < 0)
+    count = cardinalityRoaring(&races);
+  else
+    count = andCardinalityRoaring(&regionBitmaps[region], &races);
+  freeRoaring(&races);
+  return count;
+}
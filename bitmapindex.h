@@ -0,0 +1,35 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the bitmap indexes kept on the linked
+ * list. There is one compressed bitmap of node ids per region, per town and
+ * per race, so household counts are answered by combining bitmaps instead of
+ * walking the list. Should a bitmap run out of memory, the counts scan the
+ * list until it is released.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_BITMAPINDEX_H
+#define ELMERALMEIDAASSIGN3_BITMAPINDEX_H
+
+#include "almeielm.h"
+
+// race mask selecting every race, for countHouseholdsByRegionAndRaces
+#define ALL_RACES ((1u << (RACE_RANGE + 1)) - 1)
+
+/*
+ * Bitmap index administration
+ */
+void indexBitmapNode(Node *node);
+void unindexBitmapNode(Node *node);
+void clearBitmapIndex();
+
+/*
+ * Count-only queries, answered from the bitmaps alone
+ */
+long countHouseholdsByRegion(int region);
+long countHouseholdsByTown(int region, int town);
+long countHouseholdsByRace(int race);
+long countHouseholdsByRegionAndRaces(int region, unsigned raceMask);
+
+#endif // ELMERALMEIDAASSIGN3_BITMAPINDEX_H
@@ -0,0 +1,381 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the columnar household store
+ * defined in columnar.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "columnar.h"
+#include "parallel.h"
+
+// number of blocks skipped by the scans thanks to their zone maps
+static long blocksPruned = 0;
+
+/**
+ * Grow a single column to the new capacity.
+ *
+ * @param column pointer to the column array
+ * @param width size of a single value in the column
+ * @param capacity new number of values
+ * @return 1 if the column has been grown, 0 if out of memory
+ */
+static int growColumn(void **column, size_t width, long capacity) {
+  void *grown = realloc(*column, width * (size_t)capacity);
+  if (grown == NULL)
+    return 0;
+  *column = grown;
+  return 1;
+}
+
+/**
+ * Get the zone map bit of a region, town or race value
+ *
+ * @param value
+ * @return the bit standing for the value in a zone map mask
+ */
+static unsigned char zoneBit(int value) {
+  return (unsigned char)(value >= 0 && value < 7 ? 1u << value : 0x80u);
+}
+
+/**
+ * Widen a range to take in a value
+ *
+ * @param range
+ * @param value
+ */
+static void widenRange(column_range *range, int value) {
+  if (value < range->min)
+    range->min = value;
+  if (value > range->max)
+    range->max = value;
+}
+
+/**
+ * Start a zone map over from the first household of its block
+ *
+ * @param zone
+ * @param item
+ */
+void startColumnZone(column_zone *zone, household item) {
+  zone->size.min = zone->size.max = item.size;
+  zone->seniors.min = zone->seniors.max = item.seniors;
+  zone->adultsWithChronicDiseases.min = zone->adultsWithChronicDiseases.max =
+      item.adultsWithChronicDiseases;
+  zone->tested.min = zone->tested.max = item.tested;
+  zone->adultsTestedPositive.min = zone->adultsTestedPositive.max =
+      item.adultsTestedPositive;
+  zone->regionMask = zoneBit(item.region);
+  zone->townMask = zoneBit(item.town);
+  zone->raceMask = zoneBit(item.race);
+}
+
+/**
+ * Widen a zone map to take in another household of its block
+ *
+ * @param zone
+ * @param item
+ */
+void widenColumnZone(column_zone *zone, household item) {
+  widenRange(&zone->size, item.size);
+  widenRange(&zone->seniors, item.seniors);
+  widenRange(&zone->adultsWithChronicDiseases, item.adultsWithChronicDiseases);
+  widenRange(&zone->tested, item.tested);
+  widenRange(&zone->adultsTestedPositive, item.adultsTestedPositive);
+  zone->regionMask |= zoneBit(item.region);
+  zone->townMask |= zoneBit(item.town);
+  zone->raceMask |= zoneBit(item.race);
+}
+
+/**
+ * Check if a block may hold households of a region, town and race with the
+ * minimum tested positive, according to its zone map
+ *
+ * @param zone
+ * @param region negative for every region
+ * @param town negative for every town
+ * @param race negative for every race
+ * @param minTestedPositive
+ * @return 1 if the block has to be scanned, 0 if it can be skipped
+ */
+int zoneMayMatch(const column_zone *zone, int region, int town, int race,
+                 int minTestedPositive) {
+  return (region < 0 || (zone->regionMask & zoneBit(region))) &&
+         (town < 0 || (zone->townMask & zoneBit(town))) &&
+         (race < 0 || (zone->raceMask & zoneBit(race))) &&
+         zone->adultsTestedPositive.max >= minTestedPositive;
+}
+
+/**
+ * Take a row into the zone map of its block. The first row of a block starts
+ * the zone map over.
+ *
+ * @param columns
+ * @param row
+ * @param item household stored at the row
+ */
+static void addRowToZone(household_columns *columns, long row,
+                         household item) {
+  column_zone *zone = &columns->zones[row / COLUMNS_BLOCK_SIZE];
+  if (row % COLUMNS_BLOCK_SIZE == 0)
+    startColumnZone(zone, item);
+  else
+    widenColumnZone(zone, item);
+}
+
+/**
+ * Get the row after the last row of a block
+ *
+ * @param columns
+ * @param block
+ * @return end of the block
+ */
+static long blockEnd(const household_columns *columns, long block) {
+  long end = (block + 1) * COLUMNS_BLOCK_SIZE;
+  return end < columns->count ? end : columns->count;
+}
+
+/**
+ * Initialize an empty columnar store.
+ *
+ * @param columns
+ */
+void initColumns(household_columns *columns) {
+  memset(columns, 0, sizeof(*columns));
+}
+
+/**
+ * Make sure the columnar store has room for at least the specified number of
+ * households.
+ *
+ * @param columns
+ * @param capacity number of households
+ * @return 1 if there is room, 0 if out of memory
+ */
+int reserveColumns(household_columns *columns, long capacity) {
+  if (capacity <= columns->capacity)
+    return 1;
+
+  // grow every column -- a column that has already grown keeps its new size,
+  // which is harmless since capacity is only updated once all of them succeed
+  if (!growColumn((void **)&columns->region, sizeof(*columns->region),
+                  capacity) ||
+      !growColumn((void **)&columns->town, sizeof(*columns->town), capacity) ||
+      !growColumn((void **)&columns->race, sizeof(*columns->race), capacity) ||
+      !growColumn((void **)&columns->size, sizeof(*columns->size), capacity) ||
+      !growColumn((void **)&columns->seniors, sizeof(*columns->seniors),
+                  capacity) ||
+      !growColumn((void **)&columns->adultsWithChronicDiseases,
+                  sizeof(*columns->adultsWithChronicDiseases), capacity) ||
+      !growColumn((void **)&columns->tested, sizeof(*columns->tested),
+                  capacity) ||
+      !growColumn((void **)&columns->adultsTestedPositive,
+                  sizeof(*columns->adultsTestedPositive), capacity) ||
+      !growColumn((void **)&columns->zones, sizeof(*columns->zones),
+                  (capacity + COLUMNS_BLOCK_SIZE - 1) / COLUMNS_BLOCK_SIZE))
+    return 0;
+
+  columns->capacity = capacity;
+  return 1;
+}
+
+/**
+ * Store a household at a row the store already has room for, without changing
+ * the number of households. The rows of a zone map block have to be set in
+ * order, but different blocks can be set from different threads.
+ *
+ * @param columns
+ * @param row below the capacity of the store
+ * @param item household to store
+ */
+void setColumnsItem(household_columns *columns, long row, household item) {
+  columns->region[row] = (unsigned char)item.region;
+  columns->town[row] = (unsigned char)item.town;
+  columns->race[row] = (unsigned char)item.race;
+  columns->size[row] = item.size;
+  columns->seniors[row] = item.seniors;
+  columns->adultsWithChronicDiseases[row] = item.adultsWithChronicDiseases;
+  columns->tested[row] = item.tested;
+  columns->adultsTestedPositive[row] = item.adultsTestedPositive;
+  addRowToZone(columns, row, item);
+}
+
+/**
+ * Gather a single row of the columnar store back into a household item.
+ *
+ * @param columns
+ * @param row
+ * @return the household stored at the row
+ */
+household getColumnsItem(const household_columns *columns, long row) {
+  return createHousehold(
+      columns->region[row], columns->town[row], columns->race[row],
+      columns->size[row], columns->seniors[row],
+      columns->adultsWithChronicDiseases[row], columns->tested[row],
+      columns->adultsTestedPositive[row]);
+}
+
+/**
+ * Release the memory held by the columnar store and leave it empty.
+ *
+ * @param columns
+ */
+void freeColumns(household_columns *columns) {
+  free(columns->region);
+  free(columns->town);
+  free(columns->race);
+  free(columns->size);
+  free(columns->seniors);
+  free(columns->adultsWithChronicDiseases);
+  free(columns->tested);
+  free(columns->adultsTestedPositive);
+  free(columns->zones);
+  initColumns(columns);
+}
+
+/**
+ * Add blocks skipped by a scan to the blocks skipped so far -- called by the
+ * thread the scan was started from once its threads are done.
+ *
+ * @param blocks number of blocks skipped
+ */
+void addBlocksPruned(long blocks) { blocksPruned += blocks; }
+
+/**
+ * Get the number of blocks the scans have skipped so far thanks to their zone
+ * maps, on the columnar store and on the node pool
+ *
+ * @return number of blocks skipped
+ */
+long getBlocksPruned() { return blocksPruned; }
+
+/**
+ * Add up the positive tested cases of a range of blocks by region
+ *
+ * @param first block
+ * @param last block after the range
+ * @param context household_columns
+ * @param partial long cases of every region, for the thread
+ */
+static void addRegionCases(long first, long last, const void *context,
+                           void *partial) {
+  const household_columns *columns = context;
+  long cases[NUM_REGIONS] = {0};
+  long row, end = blockEnd(columns, last - 1);
+
+  for (row = first * COLUMNS_BLOCK_SIZE; row < end; row++) {
+    // households with an unknown region are left out, like the linked list
+    if (columns->region[row] < NUM_REGIONS)
+      cases[columns->region[row]] += columns->adultsTestedPositive[row];
+  }
+  memcpy(partial, cases, sizeof(cases));
+}
+
+/**
+ * Add the region cases of a thread to the region cases of the ranking
+ *
+ * @param partial long cases of every region, for the thread
+ * @param result long cases of every region
+ */
+static void mergeRegionCases(const void *partial, void *result) {
+  const long *from = partial;
+  long *into = result;
+  int i;
+  for (i = 0; i < NUM_REGIONS; i++)
+    into[i] += from[i];
+}
+
+/**
+ * Calculate the number of positive tested cases based on region -- only the
+ * region and tested positive columns are scanned, split into ranges of blocks
+ * over several threads.
+ *
+ * @param columns
+ * @param region structure
+ * @param threads most threads to scan with
+ */
+void rankColumnsPositiveTestedBasedOnRegion(const household_columns *columns,
+                                            rank_cases *region, int threads) {
+  long blocks = (columns->count + COLUMNS_BLOCK_SIZE - 1) / COLUMNS_BLOCK_SIZE;
+  long cases[NUM_REGIONS] = {0};
+  int i;
+
+  if (blocks > 0 &&
+      !runParallelRanges(blocks, COLUMNS_THREAD_GRAIN, threads, addRegionCases,
+                         mergeRegionCases, columns, cases, sizeof(cases)))
+    addRegionCases(0, blocks, columns, cases); // no memory for the threads
+
+  // Peel (0) York (1) Durham (2)
+  for (i = 0; i < NUM_REGIONS; i++) {
+    region[i].name = displayRegion(i);
+    region[i].cases = cases[i];
+  }
+}
+
+/**
+ * Add up the positive tested cases of a range of blocks by town
+ *
+ * @param first block
+ * @param last block after the range
+ * @param context household_columns
+ * @param partial long cases of every town, for the thread
+ */
+static void addTownCases(long first, long last, const void *context,
+                         void *partial) {
+  const household_columns *columns = context;
+  long cases[NUM_TOWNS] = {0};
+  long row, end = blockEnd(columns, last - 1);
+
+  for (row = first * COLUMNS_BLOCK_SIZE; row < end; row++) {
+    // every region has two towns, stored one after the other
+    if (columns->region[row] < NUM_REGIONS && columns->town[row] <= TOWN_RANGE)
+      cases[columns->region[row] * (TOWN_RANGE + 1) + columns->town[row]] +=
+          columns->adultsTestedPositive[row];
+  }
+  memcpy(partial, cases, sizeof(cases));
+}
+
+/**
+ * Add the town cases of a thread to the town cases of the ranking
+ *
+ * @param partial long cases of every town, for the thread
+ * @param result long cases of every town
+ */
+static void mergeTownCases(const void *partial, void *result) {
+  const long *from = partial;
+  long *into = result;
+  int i;
+  for (i = 0; i < NUM_TOWNS; i++)
+    into[i] += from[i];
+}
+
+/**
+ * Calculate the positive tested cases based on town -- only the region, town
+ * and tested positive columns are scanned, split into ranges of blocks over
+ * several threads.
+ *
+ * @param columns
+ * @param town structure
+ * @param threads most threads to scan with
+ */
+void rankColumnsPositiveTestedBasedOnTown(const household_columns *columns,
+                                          rank_cases *town, int threads) {
+  long blocks = (columns->count + COLUMNS_BLOCK_SIZE - 1) / COLUMNS_BLOCK_SIZE;
+  long cases[NUM_TOWNS] = {0};
+  int i;
+
+  if (blocks > 0 &&
+      !runParallelRanges(blocks, COLUMNS_THREAD_GRAIN, threads, addTownCases,
+                         mergeTownCases, columns, cases, sizeof(cases)))
+    addTownCases(0, blocks, columns, cases); // no memory for the threads
+
+  // Brampton, Mississauga, Maple, Vaughan, Whitby, Oshawa
+  for (i = 0; i < NUM_TOWNS; i++) {
+    town[i].name = displayTown(i / (TOWN_RANGE + 1), i % (TOWN_RANGE + 1));
+    town[i].cases = cases[i];
+  }
+}
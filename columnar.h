@@ -0,0 +1,97 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the columnar (struct of arrays)
+ * household store. Every household field lives in its own contiguous array so
+ * that a scan only loads the columns it filters or sums on.
+ *
+ * The store holds generated populations: the population waiting to be added
+ * to the linked list, the replicates, the epidemic and the --filter scans. The
+ * menu options keep working on the linked list.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_COLUMNAR_H
+#define ELMERALMEIDAASSIGN3_COLUMNAR_H
+
+#include "almeielm.h"
+
+// number of rows summarized by a single zone map
+#define COLUMNS_BLOCK_SIZE 1024
+// blocks worth a thread of their own in a scan
+#define COLUMNS_THREAD_GRAIN 64
+
+typedef struct column_range {
+  int min;
+  int max;
+} column_range;
+
+/*
+ * Zone map of a block of rows: the range of every household measure and which
+ * regions, towns and races appear in the block (bit n set for value n, the
+ * top bit for any value above 6). A filter skips every block its zone map
+ * rules out.
+ */
+typedef struct column_zone {
+  column_range size;
+  column_range seniors;
+  column_range adultsWithChronicDiseases;
+  column_range tested;
+  column_range adultsTestedPositive;
+  unsigned char regionMask;
+  unsigned char townMask;
+  unsigned char raceMask;
+} column_zone;
+
+// households matching a scan of blocks, and the blocks its zone maps skipped
+typedef struct block_count {
+  long households;
+  long pruned;
+} block_count;
+
+/*
+ * Region, town and race never go above 4, so they are stored a byte wide. The
+ * remaining household measures keep the int width of the household structure.
+ */
+typedef struct household_columns {
+  unsigned char *region;
+  unsigned char *town;
+  unsigned char *race;
+  int *size;
+  int *seniors;
+  int *adultsWithChronicDiseases;
+  int *tested;
+  int *adultsTestedPositive;
+  column_zone *zones; // one zone map per COLUMNS_BLOCK_SIZE rows
+  long count;         // number of households stored
+  long capacity;      // number of households the arrays have room for
+} household_columns;
+
+/*
+ * Columnar store administration
+ */
+void initColumns(household_columns *columns);
+int reserveColumns(household_columns *columns, long capacity);
+void setColumnsItem(household_columns *columns, long row, household item);
+household getColumnsItem(const household_columns *columns, long row);
+void freeColumns(household_columns *columns);
+
+/*
+ * Rank options by region and town
+ */
+void rankColumnsPositiveTestedBasedOnRegion(const household_columns *columns,
+                                            rank_cases *region, int threads);
+void rankColumnsPositiveTestedBasedOnTown(const household_columns *columns,
+                                          rank_cases *town, int threads);
+
+/*
+ * Zone maps, of the columnar store and of the node pool
+ */
+void startColumnZone(column_zone *zone, household item);
+void widenColumnZone(column_zone *zone, household item);
+int zoneMayMatch(const column_zone *zone, int region, int town, int race,
+                 int minTestedPositive);
+void addBlocksPruned(long blocks);
+long getBlocksPruned();
+
+#endif // ELMERALMEIDAASSIGN3_COLUMNAR_H
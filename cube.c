@@ -0,0 +1,142 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the data cube defined in cube.h
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cube.h"
+
+#define NUM_TOWNS_PER_REGION (TOWN_RANGE + 1)
+#define NUM_RACES (RACE_RANGE + 1)
+
+static household_totals cells[NUM_REGIONS][NUM_TOWNS_PER_REGION][NUM_RACES];
+
+/**
+ * Add (or take away) a household from a set of totals
+ *
+ * @param totals
+ * @param item
+ * @param sign 1 to add the household, -1 to take it away
+ */
+static void addHouseholdToTotals(household_totals *totals, household item,
+                                 int sign) {
+  totals->households += sign;
+  totals->size += sign * item.size;
+  totals->seniors += sign * item.seniors;
+  totals->adultsWithChronicDiseases += sign * item.adultsWithChronicDiseases;
+  totals->tested += sign * item.tested;
+  totals->adultsTestedPositive += sign * item.adultsTestedPositive;
+}
+
+/**
+ * Update the cell of the household's triplet
+ *
+ * @param item
+ * @param sign 1 to add the household, -1 to take it away
+ */
+static void updateCube(household item, int sign) {
+  // households with an unknown region, town or race are left out
+  if (item.region < 0 || item.region >= NUM_REGIONS || item.town < 0 ||
+      item.town >= NUM_TOWNS_PER_REGION || item.race < 0 ||
+      item.race >= NUM_RACES)
+    return;
+  addHouseholdToTotals(&cells[item.region][item.town][item.race], item, sign);
+}
+
+/**
+ * Add a household to the cube -- called for every node added to the linked
+ * list.
+ *
+ * @param item
+ */
+void addToCube(household item) { updateCube(item, 1); }
+
+/**
+ * Take a household away from the cube -- called for every node deleted from
+ * the linked list.
+ *
+ * @param item
+ */
+void removeFromCube(household item) { updateCube(item, -1); }
+
+/**
+ * Reset every cell -- called when the whole list is released.
+ */
+void clearCube() { memset(cells, 0, sizeof(cells)); }
+
+/**
+ * Add up the cells matching a region, town and race, any of which can be
+ * CUBE_ALL to roll up over that dimension.
+ *
+ * @param region region, or CUBE_ALL
+ * @param town town within the region, or CUBE_ALL
+ * @param race race, or CUBE_ALL
+ * @return totals of every matching cell
+ */
+household_totals rollupCube(int region, int town, int race) {
+  household_totals totals = {0};
+  int r, t, c;
+
+  for (r = 0; r < NUM_REGIONS; r++) {
+    if (region != CUBE_ALL && region != r)
+      continue;
+    for (t = 0; t < NUM_TOWNS_PER_REGION; t++) {
+      if (town != CUBE_ALL && town != t)
+        continue;
+      for (c = 0; c < NUM_RACES; c++) {
+        const household_totals *cell = &cells[r][t][c];
+        if (race != CUBE_ALL && race != c)
+          continue;
+        totals.households += cell->households;
+        totals.size += cell->size;
+        totals.seniors += cell->seniors;
+        totals.adultsWithChronicDiseases += cell->adultsWithChronicDiseases;
+        totals.tested += cell->tested;
+        totals.adultsTestedPositive += cell->adultsTestedPositive;
+      }
+    }
+  }
+  return totals;
+}
+
+/**
+ * Print a single row of the race totals table
+ *
+ * @param region name of the region
+ * @param race name of the race
+ * @param totals
+ */
+static void printTotalsRow(char *region, char *race, household_totals totals) {
+  printf("%15s\t%20s\t%10ld\t%10ld\t%10ld\t%10ld\t%15ld\n", region, race,
+         totals.households, totals.size, totals.seniors, totals.tested,
+         totals.adultsTestedPositive);
+}
+
+/**
+ * Print the totals of every race within every region, rolled up from the
+ * cube.
+ */
+void printRaceTotalsByRegion() {
+  int region, race;
+
+  printHouseholdItemSeparator();
+  printf("%15s\t%20s\t%10s\t%10s\t%10s\t%10s\t%15s\n", "Region", "Race",
+         "Households", "People", "Seniors", "Tested", "Tested Positive");
+  printHouseholdItemSeparator();
+  for (region = 0; region < NUM_REGIONS; region++) {
+    for (race = 0; race < NUM_RACES; race++)
+      printTotalsRow(displayRegion(region), displayRace(race),
+                     rollupCube(region, CUBE_ALL, race));
+    // region total over every race
+    printTotalsRow(displayRegion(region), "All",
+                   rollupCube(region, CUBE_ALL, CUBE_ALL));
+    printHouseholdItemSeparator();
+  }
+  printTotalsRow("All", "All", rollupCube(CUBE_ALL, CUBE_ALL, CUBE_ALL));
+  printHouseholdItemSeparator();
+  puts("");
+}
@@ -0,0 +1,41 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the region x town x race data cube.
+ * Every cell holds the totals of all household measures of a triplet and is
+ * updated as households are added and deleted, so any roll-up is a sum over
+ * at most 30 cells.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_CUBE_H
+#define ELMERALMEIDAASSIGN3_CUBE_H
+
+#include "almeielm.h"
+
+// roll up over every value of a dimension
+#define CUBE_ALL -1
+
+typedef struct household_totals {
+  long households;
+  long size;
+  long seniors;
+  long adultsWithChronicDiseases;
+  long tested;
+  long adultsTestedPositive;
+} household_totals;
+
+/*
+ * Data cube administration
+ */
+void addToCube(household item);
+void removeFromCube(household item);
+void clearCube();
+
+/*
+ * Roll-ups
+ */
+household_totals rollupCube(int region, int town, int race);
+void printRaceTotalsByRegion();
+
+#endif // ELMERALMEIDAASSIGN3_CUBE_H
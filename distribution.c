@@ -0,0 +1,347 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the household distributions defined
+ * in distribution.h
+ *
+ * A distribution file holds one distribution per line, as a keyword followed
+ * by the weight of every outcome. Weights don't need to add up to anything,
+ * distributions left out stay uniform, and lines starting with '#' are
+ * comments:
+ *
+ *   region 5 3 2                     Peel, York, Durham
+ *   town Peel 3 1                    towns of a region, in menu order
+ *   race York 4 2 2 1 1              race mix of a region, in menu order
+ *   size 10 30 20 ... (20 weights)   household sizes 1 to 20
+ *   positive 8 4 2 ... (20 weights)  adults tested positive 1 to 20
+ *
+ * The positive weights are cut at the number of adults tested, or the number
+ * of adults if lower, so a household never has more positive than tested.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "distribution.h"
+
+#define DISTRIBUTION_LINE_LENGTH 1024
+#define NUM_RACES (RACE_RANGE + 1)
+
+// weights read from the distribution file, before they are compiled
+typedef struct household_weights {
+  double region[NUM_REGIONS];
+  double town[NUM_REGIONS][TOWN_RANGE + 1];
+  double race[NUM_REGIONS][NUM_RACES];
+  double size[HOUSEHOLD_SIZE_RANGE];
+  double positive[HOUSEHOLD_SIZE_RANGE];
+} household_weights;
+
+/**
+ * Compile weights into an alias table with Vose's method: outcomes below the
+ * average weight are topped up by outcomes above it, so every column of the
+ * table holds at most two outcomes.
+ *
+ * @param table
+ * @param weights weight of every outcome, at least one of them above 0
+ * @param count number of outcomes
+ * @return 1 if the table has been built, 0 if the weights are invalid
+ */
+int buildAliasTable(alias_table *table, const double *weights, int count) {
+  double scaled[MAX_ALIAS_OUTCOMES], total = 0;
+  int small[MAX_ALIAS_OUTCOMES], large[MAX_ALIAS_OUTCOMES];
+  int numSmall = 0, numLarge = 0, i;
+
+  if (count < 1 || count > MAX_ALIAS_OUTCOMES)
+    return 0;
+  for (i = 0; i < count; i++) {
+    if (!(weights[i] >= 0)) // negative or not a number
+      return 0;
+    total += weights[i];
+  }
+  if (!(total > 0) || total > 1e300)
+    return 0;
+
+  // scale the weights so the average is 1, and split them around it
+  for (i = 0; i < count; i++) {
+    scaled[i] = weights[i] * count / total;
+    if (scaled[i] < 1)
+      small[numSmall++] = i;
+    else
+      large[numLarge++] = i;
+  }
+
+  while (numSmall > 0 && numLarge > 0) {
+    int lower = small[--numSmall], upper = large[--numLarge];
+    table->threshold[lower] =
+        scaled[lower] > 0 ? (uint64_t)(scaled[lower] * 4294967296.0) : 0;
+    table->alias[lower] = (unsigned char)upper;
+    scaled[upper] -= 1 - scaled[lower];
+    if (scaled[upper] < 1)
+      small[numSmall++] = upper;
+    else
+      large[numLarge++] = upper;
+  }
+
+  // what is left is at the average, up to rounding errors -- always kept
+  while (numLarge > 0) {
+    i = large[--numLarge];
+    table->threshold[i] = UINT64_C(1) << 32;
+    table->alias[i] = (unsigned char)i;
+  }
+  while (numSmall > 0) {
+    i = small[--numSmall];
+    table->threshold[i] = UINT64_C(1) << 32;
+    table->alias[i] = (unsigned char)i;
+  }
+  table->count = count;
+  return 1;
+}
+
+/**
+ * Draw an outcome from an alias table. The upper part of the product picks the
+ * column and the lower part decides between the column and its alias, so a
+ * single 32-bit random number is enough. The choice is a coin toss the branch
+ * predictor can't learn, so it is made with a mask instead of a branch.
+ *
+ * @param table
+ * @param bits 32 random bits
+ * @return outcome between 0 and the number of outcomes - 1
+ */
+static int sampleAlias(const alias_table *table, uint32_t bits) {
+  uint64_t product = (uint64_t)bits * (uint32_t)table->count;
+  int column = (int)(product >> 32);
+  int alias = table->alias[column];
+  int keep = (uint32_t)product < table->threshold[column];
+  return alias + ((column - alias) & -keep);
+}
+
+/**
+ * Fill weights with the uniform distributions of generateHousehold
+ *
+ * @param weights
+ */
+static void initWeights(household_weights *weights) {
+  int i, j;
+  for (i = 0; i < NUM_REGIONS; i++) {
+    weights->region[i] = 1;
+    for (j = 0; j <= TOWN_RANGE; j++)
+      weights->town[i][j] = 1;
+    for (j = 0; j < NUM_RACES; j++)
+      weights->race[i][j] = 1;
+  }
+  for (i = 0; i < HOUSEHOLD_SIZE_RANGE; i++) {
+    weights->size[i] = 1;
+    weights->positive[i] = 1;
+  }
+}
+
+/**
+ * Compile every distribution into its alias table
+ *
+ * @param weights
+ * @param distribution
+ * @return 1 if every distribution has been compiled, 0 otherwise
+ */
+static int compileWeights(const household_weights *weights,
+                          household_distribution *distribution) {
+  int i;
+
+  if (!buildAliasTable(&distribution->region, weights->region, NUM_REGIONS) ||
+      !buildAliasTable(&distribution->size, weights->size,
+                       HOUSEHOLD_SIZE_RANGE))
+    return 0;
+  for (i = 0; i < NUM_REGIONS; i++) {
+    if (!buildAliasTable(&distribution->town[i], weights->town[i],
+                         TOWN_RANGE + 1) ||
+        !buildAliasTable(&distribution->race[i], weights->race[i], NUM_RACES))
+      return 0;
+  }
+
+  // one table per limit on the adults tested positive -- a limit below every
+  // weighted value gets the limit itself
+  for (i = 0; i < HOUSEHOLD_SIZE_RANGE; i++) {
+    if (!buildAliasTable(&distribution->positive[i], weights->positive,
+                         i + 1)) {
+      double limit[MAX_ALIAS_OUTCOMES] = {0};
+      limit[i] = 1;
+      buildAliasTable(&distribution->positive[i], limit, i + 1);
+    }
+  }
+  return 1;
+}
+
+/**
+ * Find a region by its name
+ *
+ * @param name
+ * @return region number, -1 if there's no region of that name
+ */
+static int findRegion(const char *name) {
+  int i;
+  for (i = 0; i < NUM_REGIONS; i++) {
+    if (name != NULL && strcmp(name, displayRegion(i)) == 0)
+      return i;
+  }
+  return -1;
+}
+
+/**
+ * Read the weights following the keyword of a line
+ *
+ * @param weights where to store the weights
+ * @param count number of weights expected
+ * @return 1 if exactly count non-negative weights follow, 0 otherwise
+ */
+static int parseWeights(double *weights, int count) {
+  char *token, *end;
+  int i;
+  for (i = 0; i < count; i++) {
+    token = strtok(NULL, " \t\r\n");
+    if (token == NULL)
+      return 0;
+    weights[i] = strtod(token, &end);
+    if (*end != '\0' || !(weights[i] >= 0))
+      return 0;
+  }
+  return strtok(NULL, " \t\r\n") == NULL;
+}
+
+/**
+ * Load a distribution file and compile it into alias tables
+ *
+ * @param fileName
+ * @param distribution
+ * @return 1 if the file has been loaded, 0 otherwise
+ */
+int loadDistribution(const char *fileName,
+                     household_distribution *distribution) {
+  char line[DISTRIBUTION_LINE_LENGTH];
+  household_weights weights;
+  FILE *file;
+  int lineNumber = 0, valid = 1;
+
+  file = fopen(fileName, "r");
+  if (file == NULL) {
+    printf("Unable to read the distribution file: %s\n", fileName);
+    return 0;
+  }
+
+  initWeights(&weights);
+  while (valid && fgets(line, sizeof(line), file) != NULL) {
+    char *keyword = strtok(line, " \t\r\n");
+    int region, expected = 0;
+    double *target = NULL;
+
+    lineNumber++;
+    if (keyword == NULL || keyword[0] == '#')
+      continue;
+
+    if (strcmp(keyword, "region") == 0) {
+      target = weights.region;
+      expected = NUM_REGIONS;
+    } else if (strcmp(keyword, "town") == 0 || strcmp(keyword, "race") == 0) {
+      // the town and race weights are given for a single region
+      region = findRegion(strtok(NULL, " \t\r\n"));
+      if (region < 0) {
+        printf("%s:%d: %s expects a region name first.\n", fileName,
+               lineNumber, keyword);
+        valid = 0;
+        break;
+      }
+      target = keyword[1] == 'o' ? weights.town[region] : weights.race[region];
+      expected = keyword[1] == 'o' ? TOWN_RANGE + 1 : NUM_RACES;
+    } else if (strcmp(keyword, "size") == 0) {
+      target = weights.size;
+      expected = HOUSEHOLD_SIZE_RANGE;
+    } else if (strcmp(keyword, "positive") == 0) {
+      target = weights.positive;
+      expected = HOUSEHOLD_SIZE_RANGE;
+    } else {
+      printf("%s:%d: unknown distribution: %s\n", fileName, lineNumber,
+             keyword);
+      valid = 0;
+      break;
+    }
+
+    if (!parseWeights(target, expected)) {
+      printf("%s:%d: %s expects %d non-negative weights.\n", fileName,
+             lineNumber, keyword, expected);
+      valid = 0;
+    }
+  }
+  fclose(file);
+
+  if (valid && !compileWeights(&weights, distribution)) {
+    printf("%s: every distribution needs a weight above 0.\n", fileName);
+    valid = 0;
+  }
+  return valid;
+}
+
+/**
+ * Generate a batch of household items from a distribution, the counterpart of
+ * generateHouseholdsBatch. The region, town, race, size and adults tested
+ * positive are drawn from alias tables, the other fields keep the uniform
+ * ranges of generateHousehold, and the same invariants hold.
+ *
+ * @param distribution
+ * @param rng random number generator, seeds the lanes of the batch
+ * @param count number of households to generate
+ * @param out where to write the households
+ */
+void sampleHouseholdsBatch(const household_distribution *distribution,
+                           random_context *rng, long count, household *out) {
+  random_lanes lanes;
+  uint64_t bits[4][RANDOM_LANES]; // 8 x 32 random bits for every household
+  long first;
+  int i;
+
+  seedRandomLanes(&lanes, rng);
+  for (first = 0; first < count; first += RANDOM_LANES) {
+    int lanesUsed =
+        count - first < RANDOM_LANES ? (int)(count - first) : RANDOM_LANES;
+    for (i = 0; i < 4; i++)
+      nextRandomLanes(&lanes, bits[i]);
+
+    for (i = 0; i < lanesUsed; i++) {
+      household *item = &out[first + i];
+      int region, size, seniors, tested, adults, hasAdults, positiveLimit;
+
+      region = sampleAlias(&distribution->region, (uint32_t)bits[0][i]);
+      item->region = region + REGION_OFFSET;
+      item->town = sampleAlias(&distribution->town[region],
+                               (uint32_t)(bits[0][i] >> 32)) +
+                   TOWN_OFFSET;
+      item->race =
+          sampleAlias(&distribution->race[region], (uint32_t)bits[1][i]) +
+          RACE_OFFSET;
+      size = sampleAlias(&distribution->size, (uint32_t)(bits[1][i] >> 32)) +
+             HOUSEHOLD_SIZE_OFFSET;
+      seniors = scaleRandom((uint32_t)bits[2][i], (uint32_t)size) +
+                HOUSEHOLD_SIZE_OFFSET;
+      tested = scaleRandom((uint32_t)(bits[2][i] >> 32), (uint32_t)size) +
+               HOUSEHOLD_SIZE_OFFSET;
+      adults = numberOfAdults(size, seniors);
+
+      // draw as if there was an adult, then mask the result out if there
+      // isn't, like generateHouseholdsBatch
+      hasAdults = adults > 0;
+      positiveLimit = adults < tested ? adults : tested;
+      item->size = size;
+      item->seniors = seniors;
+      item->tested = tested;
+      item->adultsWithChronicDiseases =
+          (scaleRandom((uint32_t)bits[3][i],
+                       (uint32_t)(adults + !hasAdults)) +
+           1) &
+          -hasAdults;
+      item->adultsTestedPositive =
+          (sampleAlias(&distribution->positive[positiveLimit - hasAdults],
+                       (uint32_t)(bits[3][i] >> 32)) +
+           1) &
+          -hasAdults;
+    }
+  }
+}
@@ -0,0 +1,42 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the household distributions. Weights
+ * for the region, town, race, household size and adults tested positive are
+ * read from a config file and compiled into alias tables, so every draw costs
+ * a single random number whatever the shape of the distribution.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_DISTRIBUTION_H
+#define ELMERALMEIDAASSIGN3_DISTRIBUTION_H
+
+#include "almeielm.h"
+
+// largest number of outcomes of a distribution, the household sizes
+#define MAX_ALIAS_OUTCOMES HOUSEHOLD_SIZE_RANGE
+
+// Walker alias table -- outcome n is kept with probability threshold[n] / 2^32
+// and replaced by alias[n] otherwise
+typedef struct alias_table {
+  int count;
+  uint64_t threshold[MAX_ALIAS_OUTCOMES];
+  unsigned char alias[MAX_ALIAS_OUTCOMES];
+} alias_table;
+
+typedef struct household_distribution {
+  alias_table region;
+  alias_table town[NUM_REGIONS]; // towns of every region
+  alias_table race[NUM_REGIONS]; // race mix of every region
+  alias_table size;
+  // adults tested positive, positive[n - 1] draws between 1 and n
+  alias_table positive[HOUSEHOLD_SIZE_RANGE];
+} household_distribution;
+
+int buildAliasTable(alias_table *table, const double *weights, int count);
+int loadDistribution(const char *fileName,
+                     household_distribution *distribution);
+void sampleHouseholdsBatch(const household_distribution *distribution,
+                           random_context *rng, long count, household *out);
+
+#endif // ELMERALMEIDAASSIGN3_DISTRIBUTION_H
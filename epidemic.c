@@ -0,0 +1,381 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the epidemic simulation defined in
+ * epidemic.h
+ *
+ * Every day, the members of a household move between states by binomial
+ * draws: susceptible members are exposed with a probability set by the
+ * infectious members of the household and the infectious share of the town,
+ * exposed members turn infectious, and infectious members recover. Draws are
+ * made by inverse CDF from tables built once a day, so the day step has no
+ * branches and its inner loop is vectorized.
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "epidemic.h"
+
+// households sharing a random stream, simulated by the same thread every day
+#define EPIDEMIC_BLOCK_SIZE 65536
+// scale of the binomial tables, draws use 30 random bits
+#define BINOMIAL_SCALE (1 << 30)
+
+typedef struct epidemic_worker {
+  pthread_t thread;
+  epidemic *sim;
+  long firstBlock;        // first block simulated by the worker
+  long blockStep;         // number of workers, blocks are interleaved
+  epidemic_totals totals; // totals of the blocks of the worker
+  int started;            // 1 if the worker runs on its own thread
+} epidemic_worker;
+
+/**
+ * Build the binomial CDF table of a probability, for every number of people
+ * from 0 to the largest household
+ *
+ * @param table
+ * @param p probability of every person
+ */
+static void buildBinomialTable(binomial_table *table, double p) {
+  int n, k;
+  if (!(p > 0))
+    p = 0;
+  if (p > 1)
+    p = 1;
+
+  for (n = 0; n <= HOUSEHOLD_SIZE_RANGE; n++) {
+    double pmf = pow(1 - p, n), cdf = 0;
+    for (k = 0; k < HOUSEHOLD_SIZE_RANGE; k++) {
+      if (k < n && p < 1) {
+        cdf += pmf;
+        pmf *= (double)(n - k) / (k + 1) * p / (1 - p);
+        table->cdf[n][k] = cdf < 1 ? (int32_t)(cdf * BINOMIAL_SCALE)
+                                   : BINOMIAL_SCALE;
+      } else if (k < n) {
+        table->cdf[n][k] = 0; // certain, every person is drawn
+      } else {
+        table->cdf[n][k] = BINOMIAL_SCALE; // never passed, no more people
+      }
+    }
+  }
+}
+
+/**
+ * Draw from a binomial table. The number drawn is the number of thresholds the
+ * random number is above, counted over the whole row without a branch.
+ *
+ * @param table
+ * @param n number of people, at most HOUSEHOLD_SIZE_RANGE
+ * @param bits 30 random bits
+ * @return number of people drawn, between 0 and n
+ */
+static int drawBinomial(const binomial_table *table, int n, int32_t bits) {
+  const int32_t *cdf = table->cdf[n];
+  int k, count = 0;
+  for (k = 0; k < HOUSEHOLD_SIZE_RANGE; k++)
+    count += bits >= cdf[k];
+  return count;
+}
+
+/**
+ * Set up a simulation from a generated population. The adults tested positive
+ * of every household are infectious on the first day, everyone else is
+ * susceptible.
+ *
+ * @param sim
+ * @param columns population to simulate
+ * @param seed seed of the simulation
+ * @return 1 if the simulation has been set up, 0 if out of memory
+ */
+int initEpidemic(epidemic *sim, const household_columns *columns,
+                 uint64_t seed) {
+  long households = columns->count, row, block;
+  long blocks = (households + EPIDEMIC_BLOCK_SIZE - 1) / EPIDEMIC_BLOCK_SIZE;
+  size_t bytes = households > 0 ? (size_t)households : 1;
+  random_context stream;
+
+  memset(sim, 0, sizeof(*sim));
+  sim->households = households;
+  sim->susceptible = malloc(bytes);
+  sim->exposed = calloc(bytes, 1);
+  sim->infectious = malloc(bytes);
+  sim->town = malloc(bytes);
+  sim->streams = malloc(sizeof(*sim->streams) * (size_t)(blocks + 1));
+  sim->exposure = malloc(sizeof(*sim->exposure) * NUM_TOWNS *
+                         (HOUSEHOLD_SIZE_RANGE + 1));
+  if (sim->susceptible == NULL || sim->exposed == NULL ||
+      sim->infectious == NULL || sim->town == NULL || sim->streams == NULL ||
+      sim->exposure == NULL) {
+    freeEpidemic(sim);
+    return 0;
+  }
+
+  for (row = 0; row < households; row++) {
+    int region = columns->region[row], town = columns->town[row];
+    int size = columns->size[row];
+    int infectious = columns->adultsTestedPositive[row];
+
+    // households with an unknown region or town, or too big, are left out
+    if (region >= NUM_REGIONS || town > TOWN_RANGE || size < 0 ||
+        size > HOUSEHOLD_SIZE_RANGE) {
+      region = town = size = infectious = 0;
+    }
+    sim->town[row] = (unsigned char)(region * (TOWN_RANGE + 1) + town);
+    sim->infectious[row] = (unsigned char)infectious;
+    sim->susceptible[row] = (unsigned char)(size - infectious);
+    sim->townPeople[sim->town[row]] += size;
+    sim->totals.susceptible += size - infectious;
+    sim->totals.infectious += infectious;
+    sim->totals.townInfectious[sim->town[row]] += infectious;
+  }
+
+  // every block gets its own stream, the population itself was generated from
+  // the streams of the seed so the simulation starts from its complement
+  seedRandom(&stream, ~seed);
+  for (block = 0; block < blocks; block++) {
+    random_context blockStream = stream;
+    seedRandomLanes(&sim->streams[block], &blockStream);
+    jumpRandom(&stream);
+  }
+
+  buildBinomialTable(&sim->progression,
+                     1 - exp(-1 / EPIDEMIC_INCUBATION_DAYS));
+  buildBinomialTable(&sim->recovery, 1 - exp(-1 / EPIDEMIC_INFECTIOUS_DAYS));
+  return 1;
+}
+
+/**
+ * Simulate a single day for a block of households, adding the block to the
+ * totals of the worker
+ *
+ * @param sim
+ * @param block
+ * @param totals
+ */
+static void stepBlock(epidemic *sim, long block, epidemic_totals *totals) {
+  unsigned char *susceptible = sim->susceptible, *exposed = sim->exposed,
+                *infectious = sim->infectious, *towns = sim->town;
+  random_lanes *lanes = &sim->streams[block];
+  uint64_t bits[2][RANDOM_LANES];
+  long first = block * EPIDEMIC_BLOCK_SIZE;
+  long end = first + EPIDEMIC_BLOCK_SIZE;
+  long row;
+  int i;
+
+  if (end > sim->households)
+    end = sim->households;
+
+  for (row = first; row < end; row += RANDOM_LANES) {
+    int lanesUsed = end - row < RANDOM_LANES ? (int)(end - row) : RANDOM_LANES;
+    nextRandomLanes(lanes, bits[0]);
+    nextRandomLanes(lanes, bits[1]);
+
+    for (i = 0; i < lanesUsed; i++) {
+      long h = row + i;
+      int town = towns[h];
+      int s = susceptible[h], e = exposed[h], infected = infectious[h];
+      const binomial_table *exposure =
+          &sim->exposure[town * (HOUSEHOLD_SIZE_RANGE + 1) + infected];
+
+      // every transition of the day is drawn from the state at its start
+      int newExposed = drawBinomial(exposure, s, (int32_t)(bits[0][i] >> 34));
+      int newInfectious = drawBinomial(&sim->progression, e,
+                                       (int32_t)(bits[0][i] & 0x3FFFFFFF));
+      int newRecovered = drawBinomial(&sim->recovery, infected,
+                                      (int32_t)(bits[1][i] >> 34));
+
+      s -= newExposed;
+      e += newExposed - newInfectious;
+      infected += newInfectious - newRecovered;
+      susceptible[h] = (unsigned char)s;
+      exposed[h] = (unsigned char)e;
+      infectious[h] = (unsigned char)infected;
+
+      totals->susceptible += s;
+      totals->exposed += e;
+      totals->townInfectious[town] += infected;
+      totals->townNewCases[town] += newInfectious;
+    }
+  }
+}
+
+/**
+ * Thread entry point -- simulate the day for every block of the worker
+ *
+ * @param argument the epidemic worker
+ * @return NULL
+ */
+static void *runEpidemicWorker(void *argument) {
+  epidemic_worker *worker = argument;
+  long blocks = (worker->sim->households + EPIDEMIC_BLOCK_SIZE - 1) /
+                EPIDEMIC_BLOCK_SIZE;
+  long block;
+
+  memset(&worker->totals, 0, sizeof(worker->totals));
+  for (block = worker->firstBlock; block < blocks; block += worker->blockStep)
+    stepBlock(worker->sim, block, &worker->totals);
+  return NULL;
+}
+
+/**
+ * Simulate a single day over the whole population, from several threads. The
+ * blocks always use their own random streams, so the simulation only depends
+ * on the seed and not on the number of threads.
+ *
+ * @param sim
+ * @param threads number of threads to simulate with
+ */
+void stepEpidemic(epidemic *sim, int threads) {
+  epidemic_worker single, *workers;
+  long blocks = (sim->households + EPIDEMIC_BLOCK_SIZE - 1) /
+                EPIDEMIC_BLOCK_SIZE;
+  long people = sim->totals.susceptible + sim->totals.exposed +
+                sim->totals.infectious + sim->totals.recovered;
+  int town, infected, i;
+
+  // exposure of the day, from the infectious share of every town at its start
+  for (town = 0; town < NUM_TOWNS; town++) {
+    double share = sim->townPeople[town] > 0
+                       ? (double)sim->totals.townInfectious[town] /
+                             sim->townPeople[town]
+                       : 0;
+    for (infected = 0; infected <= HOUSEHOLD_SIZE_RANGE; infected++)
+      buildBinomialTable(
+          &sim->exposure[town * (HOUSEHOLD_SIZE_RANGE + 1) + infected],
+          1 - exp(-(EPIDEMIC_HOUSEHOLD_RATE * infected +
+                    EPIDEMIC_TOWN_RATE * share)));
+  }
+
+  if (threads < 1)
+    threads = 1;
+  if (threads > blocks)
+    threads = blocks > 0 ? (int)blocks : 1;
+  workers = malloc(sizeof(*workers) * (size_t)threads);
+  if (workers == NULL) {
+    // out of memory for the workers, simulate on the calling thread
+    workers = &single;
+    threads = 1;
+  }
+  for (i = 0; i < threads; i++) {
+    workers[i].sim = sim;
+    workers[i].firstBlock = i;
+    workers[i].blockStep = threads;
+  }
+
+  // the calling thread takes the first share, others get a thread each
+  for (i = 1; i < threads; i++)
+    workers[i].started = pthread_create(&workers[i].thread, NULL,
+                                        runEpidemicWorker, &workers[i]) == 0;
+  runEpidemicWorker(&workers[0]);
+  for (i = 1; i < threads; i++) {
+    if (workers[i].started)
+      pthread_join(workers[i].thread, NULL);
+    else
+      runEpidemicWorker(&workers[i]); // no thread for it, simulate it here
+  }
+
+  // add the totals of every worker, in order
+  memset(&sim->totals, 0, sizeof(sim->totals));
+  for (i = 0; i < threads; i++) {
+    sim->totals.susceptible += workers[i].totals.susceptible;
+    sim->totals.exposed += workers[i].totals.exposed;
+    for (town = 0; town < NUM_TOWNS; town++) {
+      sim->totals.townInfectious[town] +=
+          workers[i].totals.townInfectious[town];
+      sim->totals.townNewCases[town] += workers[i].totals.townNewCases[town];
+    }
+  }
+  for (town = 0; town < NUM_TOWNS; town++) {
+    sim->totals.infectious += sim->totals.townInfectious[town];
+    sim->totals.newCases += sim->totals.townNewCases[town];
+  }
+  sim->totals.recovered = people - sim->totals.susceptible -
+                          sim->totals.exposed - sim->totals.infectious;
+  if (workers != &single)
+    free(workers);
+}
+
+/**
+ * Release the memory of a simulation
+ *
+ * @param sim
+ */
+void freeEpidemic(epidemic *sim) {
+  free(sim->susceptible);
+  free(sim->exposed);
+  free(sim->infectious);
+  free(sim->town);
+  free(sim->streams);
+  free(sim->exposure);
+  memset(sim, 0, sizeof(*sim));
+}
+
+/**
+ * Simulate an epidemic over a population for a number of days, printing the
+ * people in every state each day, then rank the regions and towns by their new
+ * cases over the whole simulation
+ *
+ * @param columns population to simulate
+ * @param seed seed of the simulation
+ * @param days number of days to simulate
+ * @param threads number of threads to simulate with
+ * @return 1 if the simulation has run, 0 if out of memory
+ */
+int runEpidemic(const household_columns *columns, uint64_t seed, int days,
+                int threads) {
+  epidemic sim;
+  rank_cases region[NUM_REGIONS], town[NUM_TOWNS];
+  long regionCases[NUM_REGIONS] = {0}, townCases[NUM_TOWNS] = {0};
+  long peakCases = -1;
+  int day, peakDay = 0, i;
+
+  if (!initEpidemic(&sim, columns, seed))
+    return 0;
+
+  printf("\n%5s\t%12s\t%12s\t%12s\t%12s\t%12s\n", "Day", "Susceptible",
+         "Exposed", "Infectious", "Recovered", "New cases");
+  for (day = 1; day <= days; day++) {
+    stepEpidemic(&sim, threads);
+    printf("%5d\t%12ld\t%12ld\t%12ld\t%12ld\t%12ld\n", day,
+           sim.totals.susceptible, sim.totals.exposed, sim.totals.infectious,
+           sim.totals.recovered, sim.totals.newCases);
+
+    // the daily new cases add up to the rankings
+    for (i = 0; i < NUM_TOWNS; i++) {
+      townCases[i] += sim.totals.townNewCases[i];
+      regionCases[i / (TOWN_RANGE + 1)] += sim.totals.townNewCases[i];
+    }
+    if (sim.totals.newCases > peakCases) {
+      peakCases = sim.totals.newCases;
+      peakDay = day;
+    }
+  }
+  if (days > 0)
+    printf("Peak: %ld new cases on day %d\n", peakCases, peakDay);
+
+  printf("\nNew cases over %d days:\n", days);
+  for (i = 0; i < NUM_REGIONS; i++) {
+    region[i].name = displayRegion(i);
+    region[i].cases = regionCases[i];
+  }
+  for (i = 0; i < NUM_TOWNS; i++) {
+    town[i].name = displayTown(i / (TOWN_RANGE + 1), i % (TOWN_RANGE + 1));
+    town[i].cases = townCases[i];
+  }
+  printf("Region-wise Ranking:\n");
+  sortCaseRanking(region, NUM_REGIONS);
+  printCaseRanking(region, NUM_REGIONS);
+  printf("Town-wise Ranking:\n");
+  sortCaseRanking(town, NUM_TOWNS);
+  printCaseRanking(town, NUM_TOWNS);
+  puts("");
+
+  freeEpidemic(&sim);
+  return 1;
+}
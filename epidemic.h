@@ -0,0 +1,69 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the epidemic simulation. The members of
+ * every household move from susceptible to exposed, infectious and recovered
+ * (SEIR) one day at a time, infected by the infectious members of their
+ * household and the share of their town that is infectious.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_EPIDEMIC_H
+#define ELMERALMEIDAASSIGN3_EPIDEMIC_H
+
+#include <stdint.h>
+
+#include "columnar.h"
+
+#define MAX_SIMULATION_DAYS 3650
+
+// daily infection rate from every infectious member of the household
+#define EPIDEMIC_HOUSEHOLD_RATE 0.08
+// daily infection rate from the town, times the share of it that is infectious
+#define EPIDEMIC_TOWN_RATE 0.25
+// average number of days exposed before being infectious
+#define EPIDEMIC_INCUBATION_DAYS 5.0
+// average number of days infectious before recovering
+#define EPIDEMIC_INFECTIOUS_DAYS 7.0
+
+// Binomial draw by inverse CDF -- cdf[n][k] is P(X <= k) out of n, scaled to
+// 2^30, and 2^30 for k >= n so a draw never goes past n
+typedef struct binomial_table {
+  int32_t cdf[HOUSEHOLD_SIZE_RANGE + 1][HOUSEHOLD_SIZE_RANGE];
+} binomial_table;
+
+// number of people in every state, and the day's new cases
+typedef struct epidemic_totals {
+  long susceptible;
+  long exposed;
+  long infectious;
+  long recovered;
+  long newCases;                  // people who turned infectious that day
+  long townInfectious[NUM_TOWNS]; // infectious people of every town
+  long townNewCases[NUM_TOWNS];   // new cases of every town
+} epidemic_totals;
+
+typedef struct epidemic {
+  long households;
+  unsigned char *susceptible; // members of every household in every state,
+  unsigned char *exposed;     // the recovered are the rest of the household
+  unsigned char *infectious;
+  unsigned char *town;    // region * (TOWN_RANGE + 1) + town of every household
+  random_lanes *streams;  // random numbers of every block of households
+  long townPeople[NUM_TOWNS];
+  epidemic_totals totals; // totals at the end of the last day simulated
+  // exposure of a susceptible member, by town and infectious members of the
+  // household -- rebuilt every day from the infectious share of every town
+  binomial_table *exposure;
+  binomial_table progression; // exposed turning infectious
+  binomial_table recovery;    // infectious recovering
+} epidemic;
+
+int initEpidemic(epidemic *sim, const household_columns *columns,
+                 uint64_t seed);
+void stepEpidemic(epidemic *sim, int threads);
+void freeEpidemic(epidemic *sim);
+int runEpidemic(const household_columns *columns, uint64_t seed, int days,
+                int threads);
+
+#endif // ELMERALMEIDAASSIGN3_EPIDEMIC_H
@@ -0,0 +1,1047 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the filter expressions defined in
+ * filter.h
+ *
+ * Grammar of an expression, keywords in any case:
+ *
+ *   expression := term (OR term)*
+ *   term       := factor (AND factor)*
+ *   factor     := NOT factor | ( expression ) | field op value
+ *                 | field IN ( value (, value)* )
+ *   op         := = | == | != | < | <= | > | >=
+ *   field      := region | town | race | size | seniors | chronic | tested
+ *                 | positive
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "filter.h"
+#include "packed.h"
+#include "parallel.h"
+
+// kinds of nodes of a parsed expression
+#define FILTER_NODE_VALUES 0 // the values of a field, as a condition
+#define FILTER_NODE_AND 1
+#define FILTER_NODE_OR 2
+#define FILTER_NODE_NOT 3
+
+// there is never more than one node per character of an expression
+#define FILTER_MAX_NODES (FILTER_MAX_EXPRESSION + 1)
+// words of the selection of a block of the columnar store
+#define FILTER_BLOCK_WORDS (COLUMNS_BLOCK_SIZE / 64)
+
+typedef struct filter_node {
+  int kind;
+  int left;  // operands of AND, OR and NOT
+  int right;
+  int field;       // field of the values, -1 when the node mixes fields
+  uint64_t values; // values accepted, when the node only looks at one field
+  int condition;   // condition standing for the node, -1 if it has none
+} filter_node;
+
+// a filter over the columnar store, for the threads counting it
+typedef struct column_filter {
+  const household_columns *columns;
+  const household_filter *filter;
+} column_filter;
+
+typedef struct filter_parser {
+  const char *expression;
+  const char *ptr;
+  filter_node nodes[FILTER_MAX_NODES];
+  int count;
+  const char *error; // first error met, NULL while there is none
+} filter_parser;
+
+static const char *fieldNames[FILTER_FIELDS] = {
+    "region", "town", "race", "size", "seniors", "chronic", "tested",
+    "positive"};
+
+// the full household structure names are taken too
+static const char *fieldLongNames[FILTER_FIELDS] = {
+    "region", "town", "race", "size", "seniors", "adultsWithChronicDiseases",
+    "tested", "adultsTestedPositive"};
+
+static const size_t fieldOffsets[FILTER_FIELDS] = {
+    offsetof(household, region),
+    offsetof(household, town),
+    offsetof(household, race),
+    offsetof(household, size),
+    offsetof(household, seniors),
+    offsetof(household, adultsWithChronicDiseases),
+    offsetof(household, tested),
+    offsetof(household, adultsTestedPositive)};
+
+static int parseExpression(filter_parser *parser);
+
+/**
+ * Find a household field by its name, or by its name in the household
+ * structure, in any case
+ *
+ * @param name not necessarily terminated
+ * @param length of the name
+ * @return FILTER_ field, -1 if there is no such field
+ */
+int findFilterField(const char *name, size_t length) {
+  int field;
+  for (field = 0; field < FILTER_FIELDS; field++) {
+    if ((length == strlen(fieldNames[field]) &&
+         strncasecmp(name, fieldNames[field], length) == 0) ||
+        (length == strlen(fieldLongNames[field]) &&
+         strncasecmp(name, fieldLongNames[field], length) == 0))
+      return field;
+  }
+  return -1;
+}
+
+/**
+ * Get the name of a household field
+ *
+ * @param field FILTER_ field
+ * @return name
+ */
+const char *getFilterFieldName(int field) { return fieldNames[field]; }
+
+/**
+ * Get the offset of a household field in the household structure
+ *
+ * @param field FILTER_ field
+ * @return offset
+ */
+size_t getFilterFieldOffset(int field) { return fieldOffsets[field]; }
+
+/**
+ * Record the first error of a parse
+ *
+ * @param parser
+ * @param error
+ * @return -1, to return from the parsing function
+ */
+static int parseError(filter_parser *parser, const char *error) {
+  if (parser->error == NULL)
+    parser->error = error;
+  return -1;
+}
+
+/**
+ * Skip the spaces ahead of the parser
+ *
+ * @param parser
+ */
+static void skipSpaces(filter_parser *parser) {
+  while (isspace((unsigned char)*parser->ptr))
+    parser->ptr++;
+}
+
+/**
+ * Consume a symbol if it is next in the expression
+ *
+ * @param parser
+ * @param symbol
+ * @return 1 if the symbol was consumed, 0 otherwise
+ */
+static int acceptSymbol(filter_parser *parser, const char *symbol) {
+  size_t length = strlen(symbol);
+  skipSpaces(parser);
+  if (strncmp(parser->ptr, symbol, length) != 0)
+    return 0;
+  parser->ptr += length;
+  return 1;
+}
+
+/**
+ * Get the length of the word ahead of the parser
+ *
+ * @param parser
+ * @return number of letters, digits and underscores
+ */
+static size_t wordLength(filter_parser *parser) {
+  size_t length = 0;
+  skipSpaces(parser);
+  while (isalnum((unsigned char)parser->ptr[length]) ||
+         parser->ptr[length] == '_')
+    length++;
+  return length;
+}
+
+/**
+ * Consume a keyword, in any case, if it is the next word of the expression
+ *
+ * @param parser
+ * @param keyword
+ * @return 1 if the keyword was consumed, 0 otherwise
+ */
+static int acceptKeyword(filter_parser *parser, const char *keyword) {
+  size_t length = wordLength(parser);
+  if (length != strlen(keyword) ||
+      strncasecmp(parser->ptr, keyword, length) != 0)
+    return 0;
+  parser->ptr += length;
+  return 1;
+}
+
+/**
+ * Add a node to the parsed expression
+ *
+ * @param parser
+ * @param kind
+ * @param left
+ * @param right
+ * @return index of the node, -1 if the expression has too many
+ */
+static int addFilterNode(filter_parser *parser, int kind, int left,
+                         int right) {
+  filter_node *node;
+  if (left < 0 || right < 0)
+    return -1;
+  if (parser->count == FILTER_MAX_NODES)
+    return parseError(parser, "the expression is too long");
+  node = &parser->nodes[parser->count];
+  node->kind = kind;
+  node->left = left;
+  node->right = right;
+  node->field = -1;
+  node->values = 0;
+  node->condition = -1;
+  return parser->count++;
+}
+
+/**
+ * Parse a value of a comparison
+ *
+ * @param parser
+ * @param value where to store the value
+ * @return 1 if a value was parsed, 0 otherwise
+ */
+static int parseValue(filter_parser *parser, int *value) {
+  char *end;
+  long parsed;
+  skipSpaces(parser);
+  if (!isdigit((unsigned char)*parser->ptr)) {
+    parseError(parser, "expected a non-negative integer");
+    return 0;
+  }
+  parsed = strtol(parser->ptr, &end, 10);
+  if (parsed > FILTER_MAX_VALUE) {
+    parseError(parser, "values go up to 62");
+    return 0;
+  }
+  parser->ptr = end;
+  *value = (int)parsed;
+  return 1;
+}
+
+/**
+ * Get the values of a field, besides the top bit, comparing against a value.
+ * The top bit stands for the values above FILTER_MAX_VALUE, which compare like
+ * any value above the one given.
+ *
+ * @param op comparison, as written in the expression
+ * @param value
+ * @return values of the field for which the comparison holds
+ */
+static uint64_t comparisonValues(const char *op, int value) {
+  uint64_t bit = (uint64_t)1 << value;
+  uint64_t below = bit - 1; // values less than the value given
+  uint64_t equal = bit;
+  uint64_t above = ~(below | bit);
+
+  if (strcmp(op, "!=") == 0)
+    return below | above;
+  if (strcmp(op, "<=") == 0)
+    return below | equal;
+  if (strcmp(op, ">=") == 0)
+    return equal | above;
+  if (strcmp(op, "<") == 0)
+    return below;
+  if (strcmp(op, ">") == 0)
+    return above;
+  return equal;
+}
+
+/**
+ * Parse a comparison of a field -- field op value, or field IN (values)
+ *
+ * @param parser
+ * @return index of the node, -1 if the comparison is invalid
+ */
+static int parseComparison(filter_parser *parser) {
+  // longer operators first, so <= isn't taken for <
+  static const char *ops[] = {"==", "!=", "<=", ">=", "=", "<", ">"};
+  size_t length = wordLength(parser);
+  int field, node, value;
+  size_t i;
+
+  field = findFilterField(parser->ptr, length);
+  if (field < 0)
+    return parseError(parser, "expected a field name");
+  parser->ptr += length;
+
+  node = addFilterNode(parser, FILTER_NODE_VALUES, 0, 0);
+  if (node < 0)
+    return -1;
+  parser->nodes[node].field = field;
+
+  if (acceptKeyword(parser, "IN")) {
+    if (!acceptSymbol(parser, "("))
+      return parseError(parser, "expected ( after IN");
+    do {
+      if (!parseValue(parser, &value))
+        return -1;
+      parser->nodes[node].values |= (uint64_t)1 << value;
+    } while (acceptSymbol(parser, ","));
+    if (!acceptSymbol(parser, ")"))
+      return parseError(parser, "expected , or ) in the values of IN");
+    return node;
+  }
+
+  for (i = 0; i < sizeof(ops) / sizeof(ops[0]); i++) {
+    if (acceptSymbol(parser, ops[i]))
+      break;
+  }
+  if (i == sizeof(ops) / sizeof(ops[0]))
+    return parseError(parser, "expected a comparison or IN");
+  if (!parseValue(parser, &value))
+    return -1;
+  parser->nodes[node].values = comparisonValues(ops[i], value);
+  return node;
+}
+
+/**
+ * Parse a factor -- a negation, an expression in parentheses or a comparison
+ *
+ * @param parser
+ * @return index of the node, -1 if the factor is invalid
+ */
+static int parseFactor(filter_parser *parser) {
+  int node;
+  if (acceptKeyword(parser, "NOT"))
+    return addFilterNode(parser, FILTER_NODE_NOT, parseFactor(parser), 0);
+  if (acceptSymbol(parser, "(")) {
+    node = parseExpression(parser);
+    if (node >= 0 && !acceptSymbol(parser, ")"))
+      return parseError(parser, "expected )");
+    return node;
+  }
+  return parseComparison(parser);
+}
+
+/**
+ * Parse a term -- factors joined by AND
+ *
+ * @param parser
+ * @return index of the node, -1 if the term is invalid
+ */
+static int parseTerm(filter_parser *parser) {
+  int node = parseFactor(parser);
+  while (node >= 0 && acceptKeyword(parser, "AND"))
+    node = addFilterNode(parser, FILTER_NODE_AND, node, parseFactor(parser));
+  return node;
+}
+
+/**
+ * Parse an expression -- terms joined by OR
+ *
+ * @param parser
+ * @return index of the node, -1 if the expression is invalid
+ */
+static int parseExpression(filter_parser *parser) {
+  int node = parseTerm(parser);
+  while (node >= 0 && acceptKeyword(parser, "OR"))
+    node = addFilterNode(parser, FILTER_NODE_OR, node, parseTerm(parser));
+  return node;
+}
+
+/**
+ * Fold every part of an expression that only looks at one field into the
+ * values of that field, from the leaves up
+ *
+ * @param parser
+ * @param index of the node to fold
+ */
+static void foldFilterNode(filter_parser *parser, int index) {
+  filter_node *node = &parser->nodes[index];
+  const filter_node *left, *right;
+
+  if (node->kind == FILTER_NODE_VALUES)
+    return;
+  foldFilterNode(parser, node->left);
+  left = &parser->nodes[node->left];
+  if (node->kind == FILTER_NODE_NOT) {
+    node->field = left->field;
+    node->values = ~left->values;
+    return;
+  }
+
+  foldFilterNode(parser, node->right);
+  right = &parser->nodes[node->right];
+  if (left->field < 0 || left->field != right->field)
+    return;
+  node->field = left->field;
+  node->values = node->kind == FILTER_NODE_AND ? left->values & right->values
+                                               : left->values | right->values;
+}
+
+/**
+ * Give every folded part of an expression a condition of the filter. Parts
+ * with the same field and values share their condition.
+ *
+ * @param parser
+ * @param index of the node
+ * @param filter
+ * @return 1 if the filter has room for the conditions, 0 otherwise
+ */
+static int assignConditions(filter_parser *parser, int index,
+                            household_filter *filter) {
+  filter_node *node = &parser->nodes[index];
+  int i;
+
+  if (node->field < 0)
+    return assignConditions(parser, node->left, filter) &&
+           (node->kind == FILTER_NODE_NOT ||
+            assignConditions(parser, node->right, filter));
+
+  for (i = 0; i < filter->count; i++) {
+    if (filter->conditions[i].field == node->field &&
+        filter->conditions[i].values == node->values)
+      break;
+  }
+  if (i == FILTER_MAX_CONDITIONS)
+    return 0;
+  if (i == filter->count) {
+    filter->conditions[i].field = node->field;
+    filter->conditions[i].offset = fieldOffsets[node->field];
+    filter->conditions[i].values = node->values;
+    filter->fields |= 1u << node->field;
+    filter->count++;
+  }
+  node->condition = i;
+  return 1;
+}
+
+/**
+ * Evaluate an expression from whether each of its conditions holds
+ *
+ * @param parser
+ * @param index of the node
+ * @param bits bit n set when the condition n holds
+ * @return 1 if the expression holds, 0 otherwise
+ */
+static int evaluateFilterNode(const filter_parser *parser, int index,
+                              unsigned bits) {
+  const filter_node *node = &parser->nodes[index];
+  if (node->condition >= 0)
+    return (int)((bits >> node->condition) & 1);
+  if (node->kind == FILTER_NODE_NOT)
+    return !evaluateFilterNode(parser, node->left, bits);
+  if (node->kind == FILTER_NODE_AND)
+    return evaluateFilterNode(parser, node->left, bits) &&
+           evaluateFilterNode(parser, node->right, bits);
+  return evaluateFilterNode(parser, node->left, bits) ||
+         evaluateFilterNode(parser, node->right, bits);
+}
+
+/**
+ * Check whether the values of a condition are a single run of values
+ *
+ * @param values
+ * @return 1 if the set bits of values are next to each other, 0 otherwise
+ */
+static int isValueRun(uint64_t values) {
+  uint64_t run;
+  if (values == 0)
+    return 0;
+  run = values >> __builtin_ctzll(values);
+  return (run & (run + 1)) == 0;
+}
+
+/**
+ * Set the kernel of a condition from its values or, when they make a better
+ * kernel, from the values it doesn't accept: a run of values for equality,
+ * thresholds and ranges, a short list for IN, and a row at a time otherwise.
+ *
+ * @param condition
+ */
+static void planCondition(filter_condition *condition) {
+  const uint64_t top = (uint64_t)1 << (FILTER_MAX_VALUE + 1);
+  int inverted;
+
+  condition->inverted = 0;
+  condition->inCount = 0;
+  if (condition->values == 0) {
+    // an empty range selects nothing
+    condition->kernel = FILTER_KERNEL_RANGE;
+    condition->low = 1;
+    condition->high = 0;
+    return;
+  }
+
+  for (inverted = 0; inverted <= 1; inverted++) {
+    uint64_t values = inverted ? ~condition->values : condition->values;
+    if (isValueRun(values)) {
+      condition->kernel = FILTER_KERNEL_RANGE;
+      condition->inverted = inverted;
+      condition->low = (unsigned)__builtin_ctzll(values);
+      // the top bit stands for every value above, there is no limit
+      condition->high = values & top ? SELECTION_NO_LIMIT
+                                     : (unsigned)(63 - __builtin_clzll(values));
+      return;
+    }
+  }
+
+  for (inverted = 0; inverted <= 1; inverted++) {
+    uint64_t values = inverted ? ~condition->values : condition->values;
+    if (!(values & top) && __builtin_popcountll(values) <= SELECTION_MAX_IN) {
+      condition->kernel = FILTER_KERNEL_IN;
+      condition->inverted = inverted;
+      while (values != 0) {
+        condition->in[condition->inCount++] =
+            (unsigned)__builtin_ctzll(values);
+        values &= values - 1;
+      }
+      return;
+    }
+  }
+  condition->kernel = FILTER_KERNEL_VALUES;
+}
+
+/**
+ * Write an expression out as a postfix program over its conditions
+ *
+ * @param parser
+ * @param index of the node
+ * @param filter
+ */
+static void emitFilterProgram(const filter_parser *parser, int index,
+                              household_filter *filter) {
+  const filter_node *node = &parser->nodes[index];
+  if (node->condition >= 0) {
+    filter->program[filter->steps++] = (signed char)node->condition;
+    return;
+  }
+  emitFilterProgram(parser, node->left, filter);
+  if (node->kind == FILTER_NODE_NOT) {
+    filter->program[filter->steps++] = FILTER_STEP_NOT;
+    return;
+  }
+  emitFilterProgram(parser, node->right, filter);
+  filter->program[filter->steps++] =
+      node->kind == FILTER_NODE_AND ? FILTER_STEP_AND : FILTER_STEP_OR;
+}
+
+/**
+ * Parse and compile a filter expression. An invalid expression is reported
+ * with where it went wrong.
+ *
+ * @param expression
+ * @param filter where to store the compiled filter
+ * @return 1 if the expression is valid, 0 otherwise
+ */
+int compileFilter(const char *expression, household_filter *filter) {
+  filter_parser *parser;
+  unsigned bits;
+  int root, i;
+
+  if (strlen(expression) > FILTER_MAX_EXPRESSION) {
+    printf("The filter expression is longer than %d characters.\n",
+           FILTER_MAX_EXPRESSION);
+    return 0;
+  }
+  parser = malloc(sizeof(*parser));
+  if (parser == NULL) {
+    printf("Not enough memory to compile the filter expression.\n");
+    return 0;
+  }
+  parser->expression = parser->ptr = expression;
+  parser->count = 0;
+  parser->error = NULL;
+
+  root = parseExpression(parser);
+  skipSpaces(parser);
+  if (root >= 0 && *parser->ptr != '\0')
+    root = parseError(parser, "expected AND, OR or the end of the expression");
+  if (root < 0) {
+    printf("Invalid filter expression, %s at column %d:\n%s\n%*s^\n",
+           parser->error, (int)(parser->ptr - expression) + 1, expression,
+           (int)(parser->ptr - expression), "");
+    free(parser);
+    return 0;
+  }
+
+  memset(filter, 0, sizeof(*filter));
+  foldFilterNode(parser, root);
+  if (!assignConditions(parser, root, filter)) {
+    printf("The filter expression has more than %d distinct conditions.\n",
+           FILTER_MAX_CONDITIONS);
+    free(parser);
+    return 0;
+  }
+  for (bits = 0; bits < 1u << filter->count; bits++) {
+    if (evaluateFilterNode(parser, root, bits))
+      filter->table[bits >> 6] |= (uint64_t)1 << (bits & 63);
+  }
+  for (i = 0; i < filter->count; i++)
+    planCondition(&filter->conditions[i]);
+  emitFilterProgram(parser, root, filter);
+  free(parser);
+  return 1;
+}
+
+/**
+ * Visit every household of the linked list matching a filter, from the head
+ * of the list
+ *
+ * @param head
+ * @param filter
+ * @param visit called with every matching household, NULL to only count them
+ * @param sink passed on to the visitor
+ * @return number of matching households
+ */
+long filterLinkedList(Node *head, const household_filter *filter,
+                      household_visitor visit, void *sink) {
+  Node *ptr;
+  long count = 0;
+
+  if (visit == NULL) {
+    for (ptr = head; ptr != NULL; ptr = ptr->next) {
+      household item = getNodeHousehold(ptr);
+      count += matchesFilter(filter, &item);
+    }
+    return count;
+  }
+
+  for (ptr = head; ptr != NULL; ptr = ptr->next) {
+    household item = getNodeHousehold(ptr);
+    if (matchesFilter(filter, &item)) {
+      visit(&item, sink);
+      count++;
+    }
+  }
+  return count;
+}
+
+/**
+ * Get the values a range of a zone map may hold
+ *
+ * @param range
+ * @return bit n set when the value n may be in the block
+ */
+static uint64_t rangeValues(column_range range) {
+  uint64_t values = 0;
+  if (range.min < 0) {
+    // negative values stand with the values above FILTER_MAX_VALUE
+    values = (uint64_t)1 << (FILTER_MAX_VALUE + 1);
+    range.min = 0;
+  }
+  if (range.max >= range.min)
+    values |= (~(uint64_t)0 >> (FILTER_MAX_VALUE + 1 -
+                                filterValueBit(range.max))) &
+              (~(uint64_t)0 << filterValueBit(range.min));
+  return values;
+}
+
+/**
+ * Get the values a mask of a zone map may hold -- bit n for the value n, the
+ * top bit for any value above 6
+ *
+ * @param mask
+ * @return bit n set when the value n may be in the block
+ */
+static uint64_t maskValues(unsigned char mask) {
+  uint64_t values = mask & 0x7fu;
+  if (mask & 0x80u)
+    values |= ~(uint64_t)0 << 7;
+  return values;
+}
+
+/**
+ * Get the values of a field a block of the columnar store may hold
+ *
+ * @param zone of the block
+ * @param field
+ * @return bit n set when the value n may be in the block
+ */
+static uint64_t zoneValues(const column_zone *zone, int field) {
+  switch (field) {
+  case FILTER_REGION:
+    return maskValues(zone->regionMask);
+  case FILTER_TOWN:
+    return maskValues(zone->townMask);
+  case FILTER_RACE:
+    return maskValues(zone->raceMask);
+  case FILTER_SIZE:
+    return rangeValues(zone->size);
+  case FILTER_SENIORS:
+    return rangeValues(zone->seniors);
+  case FILTER_CHRONIC:
+    return rangeValues(zone->adultsWithChronicDiseases);
+  case FILTER_TESTED:
+    return rangeValues(zone->tested);
+  default:
+    return rangeValues(zone->adultsTestedPositive);
+  }
+}
+
+/**
+ * Select the rows of a block with a value of a condition, a row at a time
+ *
+ * @param column first row of the block
+ * @param rows
+ * @param values
+ * @param selection of the rows
+ */
+static void selectByteValues(const unsigned char *column, long rows,
+                             uint64_t values, uint64_t *selection) {
+  long row;
+  memset(selection, 0, (size_t)selectionWords(rows) * sizeof(*selection));
+  for (row = 0; row < rows; row++)
+    selection[row / 64] |= ((values >> filterValueBit(column[row])) & 1)
+                           << (row % 64);
+}
+
+/**
+ * Select the rows of a block with a value of a condition, a row at a time
+ *
+ * @param column first row of the block
+ * @param rows
+ * @param values
+ * @param selection of the rows
+ */
+static void selectIntValues(const int *column, long rows, uint64_t values,
+                            uint64_t *selection) {
+  long row;
+  memset(selection, 0, (size_t)selectionWords(rows) * sizeof(*selection));
+  for (row = 0; row < rows; row++)
+    selection[row / 64] |= ((values >> filterValueBit(column[row])) & 1)
+                           << (row % 64);
+}
+
+/**
+ * Select the rows of a byte column matching a condition, with its kernel
+ *
+ * @param column first row of the block
+ * @param rows
+ * @param condition
+ * @param selection of the rows
+ */
+static void selectByteCondition(const unsigned char *column, long rows,
+                                const filter_condition *condition,
+                                uint64_t *selection) {
+  if (condition->kernel == FILTER_KERNEL_RANGE)
+    selectByteRange(column, rows, condition->low, condition->high, selection);
+  else if (condition->kernel == FILTER_KERNEL_IN)
+    selectByteIn(column, rows, condition->in, condition->inCount, selection);
+  else
+    selectByteValues(column, rows, condition->values, selection);
+}
+
+/**
+ * Select the rows of an int column matching a condition, with its kernel
+ *
+ * @param column first row of the block
+ * @param rows
+ * @param condition
+ * @param selection of the rows
+ */
+static void selectIntCondition(const int *column, long rows,
+                               const filter_condition *condition,
+                               uint64_t *selection) {
+  if (condition->kernel == FILTER_KERNEL_RANGE)
+    selectIntRange(column, rows, condition->low, condition->high, selection);
+  else if (condition->kernel == FILTER_KERNEL_IN)
+    selectIntIn(column, rows, condition->in, condition->inCount, selection);
+  else
+    selectIntValues(column, rows, condition->values, selection);
+}
+
+/**
+ * Select the rows of a block of the columnar store matching a condition
+ *
+ * @param columns
+ * @param start first row of the block
+ * @param rows
+ * @param condition
+ * @param selection of the rows
+ */
+static void selectCondition(const household_columns *columns, long start,
+                            long rows, const filter_condition *condition,
+                            uint64_t *selection) {
+  long word;
+  switch (condition->field) {
+  case FILTER_REGION:
+    selectByteCondition(columns->region + start, rows, condition, selection);
+    break;
+  case FILTER_TOWN:
+    selectByteCondition(columns->town + start, rows, condition, selection);
+    break;
+  case FILTER_RACE:
+    selectByteCondition(columns->race + start, rows, condition, selection);
+    break;
+  case FILTER_SIZE:
+    selectIntCondition(columns->size + start, rows, condition, selection);
+    break;
+  case FILTER_SENIORS:
+    selectIntCondition(columns->seniors + start, rows, condition, selection);
+    break;
+  case FILTER_CHRONIC:
+    selectIntCondition(columns->adultsWithChronicDiseases + start, rows,
+                       condition, selection);
+    break;
+  case FILTER_TESTED:
+    selectIntCondition(columns->tested + start, rows, condition, selection);
+    break;
+  default:
+    selectIntCondition(columns->adultsTestedPositive + start, rows, condition,
+                       selection);
+    break;
+  }
+  if (condition->inverted) {
+    for (word = 0; word < selectionWords(rows); word++)
+      selection[word] = ~selection[word];
+  }
+}
+
+/**
+ * Run the program of a filter over a word of the selections of its
+ * conditions
+ *
+ * @param filter
+ * @param selections of every condition
+ * @param word of the selections
+ * @return rows of the word matching the filter
+ */
+static uint64_t runFilterProgram(const household_filter *filter,
+                                 uint64_t (*selections)[FILTER_BLOCK_WORDS],
+                                 long word) {
+  uint64_t stack[FILTER_MAX_PROGRAM];
+  int top = -1, step;
+  for (step = 0; step < filter->steps; step++) {
+    int op = filter->program[step];
+    if (op >= 0)
+      stack[++top] = selections[op][word];
+    else if (op == FILTER_STEP_NOT)
+      stack[top] = ~stack[top];
+    else if (op == FILTER_STEP_AND) {
+      top--;
+      stack[top] &= stack[top + 1];
+    } else {
+      top--;
+      stack[top] |= stack[top + 1];
+    }
+  }
+  return stack[0];
+}
+
+/**
+ * Get the number of blocks of the columnar store
+ *
+ * @param columns
+ * @return blocks, the last one may be short
+ */
+static long columnBlocks(const household_columns *columns) {
+  return (columns->count + COLUMNS_BLOCK_SIZE - 1) / COLUMNS_BLOCK_SIZE;
+}
+
+/**
+ * Visit every household of a range of blocks of the columnar store matching a
+ * filter, in the order of the rows. The store is filtered a block at a time:
+ * the selection kernels select the rows of every condition over the column of
+ * its field, and the program of the filter combines them. A condition the zone
+ * map of a block settles isn't scanned, and a block settled by its zone map
+ * altogether is taken or skipped as a whole.
+ *
+ * @param columns
+ * @param filter
+ * @param first block
+ * @param last block after the range
+ * @param visit called with every matching household, NULL to only count them
+ * @param sink passed on to the visitor
+ * @param pruned where to add the number of blocks skipped as a whole
+ * @return number of matching households
+ */
+static long filterColumnBlocks(const household_columns *columns,
+                               const household_filter *filter, long first,
+                               long last, household_visitor visit, void *sink,
+                               long *pruned) {
+  uint64_t selections[FILTER_MAX_CONDITIONS][FILTER_BLOCK_WORDS];
+  long block, count = 0;
+
+  for (block = first; block < last; block++) {
+    long start = block * COLUMNS_BLOCK_SIZE;
+    long rows = columns->count - start < COLUMNS_BLOCK_SIZE
+                    ? columns->count - start
+                    : COLUMNS_BLOCK_SIZE;
+    long words = selectionWords(rows), word;
+    unsigned settled = 0; // bits of the conditions holding for every row
+    int scanned = 0, i;
+
+    for (i = 0; i < filter->count; i++) {
+      const filter_condition *condition = &filter->conditions[i];
+      uint64_t values =
+          zoneValues(&columns->zones[block], condition->field);
+      if (!(values & condition->values)) {
+        // holds for no row of the block
+        memset(selections[i], 0, (size_t)words * sizeof(uint64_t));
+      } else if (!(values & ~condition->values)) {
+        // holds for every row of the block
+        settled |= 1u << i;
+        memset(selections[i], 0xff, (size_t)words * sizeof(uint64_t));
+      } else {
+        selectCondition(columns, start, rows, condition, selections[i]);
+        scanned = 1;
+      }
+    }
+
+    if (!scanned) {
+      // the zone map settles the whole block
+      if (!((filter->table[settled >> 6] >> (settled & 63)) & 1)) {
+        ++*pruned;
+        continue;
+      }
+      if (visit == NULL) {
+        count += rows;
+        continue;
+      }
+    }
+
+    for (word = 0; word < words; word++) {
+      uint64_t match = runFilterProgram(filter, selections, word);
+      if (word == words - 1 && rows % 64 != 0)
+        match &= ((uint64_t)1 << (rows % 64)) - 1; // past the last row
+      if (visit == NULL) {
+        count += __builtin_popcountll(match);
+        continue;
+      }
+      // gather the whole household of every row selected
+      while (match != 0) {
+        household item =
+            getColumnsItem(columns, start + word * 64 + __builtin_ctzll(match));
+        visit(&item, sink);
+        count++;
+        match &= match - 1;
+      }
+    }
+  }
+  return count;
+}
+
+/**
+ * Visit every household of the columnar store matching a filter, in the order
+ * of the rows
+ *
+ * @param columns
+ * @param filter
+ * @param visit called with every matching household, NULL to only count them
+ * @param sink passed on to the visitor
+ * @return number of matching households
+ */
+long filterColumns(const household_columns *columns,
+                   const household_filter *filter, household_visitor visit,
+                   void *sink) {
+  long pruned = 0, count = filterColumnBlocks(
+                       columns, filter, 0, columnBlocks(columns), visit, sink,
+                       &pruned);
+  addBlocksPruned(pruned);
+  return count;
+}
+
+/**
+ * Count the households of a range of blocks matching a filter
+ *
+ * @param first block
+ * @param last block after the range
+ * @param context column_filter
+ * @param partial block_count of the thread
+ */
+static void countColumnBlocks(long first, long last, const void *context,
+                              void *partial) {
+  const column_filter *scan = context;
+  block_count *count = partial;
+  count->households = filterColumnBlocks(scan->columns, scan->filter, first,
+                                         last, NULL, NULL, &count->pruned);
+}
+
+/**
+ * Add the count of a thread to the count of the scan
+ *
+ * @param partial block_count of the thread
+ * @param result block_count
+ */
+static void mergeColumnCount(const void *partial, void *result) {
+  const block_count *from = partial;
+  block_count *into = result;
+  into->households += from->households;
+  into->pruned += from->pruned;
+}
+
+/**
+ * Count the households of the columnar store matching a filter, from several
+ * threads. Every thread counts a range of blocks.
+ *
+ * @param columns
+ * @param filter
+ * @param threads most threads to count with
+ * @return number of matching households
+ */
+long countFilteredColumns(const household_columns *columns,
+                          const household_filter *filter, int threads) {
+  column_filter scan;
+  block_count count = {0, 0};
+  scan.columns = columns;
+  scan.filter = filter;
+  if (!runParallelRanges(columnBlocks(columns), COLUMNS_THREAD_GRAIN, threads,
+                         countColumnBlocks, mergeColumnCount, &scan, &count,
+                         sizeof(count)))
+    countColumnBlocks(0, columnBlocks(columns), &scan, &count);
+  addBlocksPruned(count.pruned);
+  return count.households;
+}
+
+/**
+ * Visit every household of a households file, as written by
+ * storeDataToFile, matching a filter. Household files don't keep the seniors
+ * and adults with chronic diseases of a household, so a filter on them is
+ * refused.
+ *
+ * @param fileName
+ * @param filter
+ * @param visit called with every matching household, NULL to only count them
+ * @param sink passed on to the visitor
+ * @return number of matching households, -1 if the file can't be filtered
+ */
+long filterHouseholdFile(const char *fileName, const household_filter *filter,
+                         household_visitor visit, void *sink) {
+  char line[256];
+  household item;
+  FILE *file;
+  long count = 0;
+
+  if (filter->fields & (1u << FILTER_SENIORS | 1u << FILTER_CHRONIC)) {
+    printf("Household files don't keep seniors or adults with chronic "
+           "diseases to filter on.\n");
+    return -1;
+  }
+  file = fopen(fileName, "r");
+  if (file == NULL) {
+    printf("Unable to open the file: %s\n", fileName);
+    return -1;
+  }
+
+  // the header and any line that isn't a household are passed over
+  while (fgets(line, sizeof(line), file) != NULL) {
+    if (!parseHouseholdRecord(line, &item) || !matchesFilter(filter, &item))
+      continue;
+    if (visit != NULL)
+      visit(&item, sink);
+    count++;
+  }
+  fclose(file);
+  return count;
+}
@@ -0,0 +1,137 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of filter expressions over households, for
+ * example "region=1 AND race IN (0,3) AND tested>=5 AND seniors>0".
+ *
+ * An expression is parsed once and compiled: every part of it that only looks
+ * at a single field becomes one condition -- the set of values of the field it
+ * accepts, as a bitmask -- and the way the conditions are combined becomes a
+ * truth table. A household is then matched by looking up the bits of its
+ * conditions in the table, without walking the expression.
+ *
+ * The columnar store is filtered a block at a time instead: the selection
+ * kernels turn every condition into a bitmask of the rows of the block, and a
+ * postfix program of the expression combines the bitmasks 64 rows at a time.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_FILTER_H
+#define ELMERALMEIDAASSIGN3_FILTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "columnar.h"
+#include "scan.h"
+#include "selection.h"
+
+// household fields an expression can filter on
+#define FILTER_REGION 0
+#define FILTER_TOWN 1
+#define FILTER_RACE 2
+#define FILTER_SIZE 3
+#define FILTER_SENIORS 4
+#define FILTER_CHRONIC 5  // adults with chronic diseases
+#define FILTER_TESTED 6
+#define FILTER_POSITIVE 7 // adults tested positive
+#define FILTER_FIELDS 8
+
+// bit n of a condition stands for the value n, the top bit for any value above
+#define FILTER_MAX_VALUE 62
+// the truth table has a bit for every combination of conditions
+#define FILTER_MAX_CONDITIONS 12
+#define FILTER_MAX_EXPRESSION 255
+// there is never more than one step per character of an expression
+#define FILTER_MAX_PROGRAM (FILTER_MAX_EXPRESSION + 1)
+
+// how the columnar store selects the rows of a condition
+#define FILTER_KERNEL_RANGE 0  // values from low to high
+#define FILTER_KERNEL_IN 1     // values listed in in
+#define FILTER_KERNEL_VALUES 2 // any other set, a row at a time
+
+// steps of a program besides pushing the selection of a condition
+#define FILTER_STEP_AND -1
+#define FILTER_STEP_OR -2
+#define FILTER_STEP_NOT -3
+
+typedef struct filter_condition {
+  int field;
+  size_t offset;   // of the field in the household structure
+  uint64_t values; // bit n set when the value n is accepted
+  int kernel;      // FILTER_KERNEL_ selecting the rows of the condition
+  int inverted;    // 1 when the kernel selects the rows that don't match
+  unsigned low;    // range of FILTER_KERNEL_RANGE
+  unsigned high;
+  unsigned in[SELECTION_MAX_IN]; // values of FILTER_KERNEL_IN
+  int inCount;
+} filter_condition;
+
+typedef struct household_filter {
+  filter_condition conditions[FILTER_MAX_CONDITIONS];
+  int count;       // number of conditions
+  unsigned fields; // bit n set when the field n is filtered on
+  // bit n set when the conditions whose bits make up n match the household
+  uint64_t table[(1 << FILTER_MAX_CONDITIONS) / 64];
+  // the expression in postfix order over the selections of the conditions,
+  // for a condition its number, or a FILTER_STEP_
+  signed char program[FILTER_MAX_PROGRAM];
+  int steps;
+} household_filter;
+
+/**
+ * Get the bit standing for a value in the values of a condition
+ *
+ * @param value
+ * @return bit, the top one for values above FILTER_MAX_VALUE
+ */
+static inline unsigned filterValueBit(int value) {
+  unsigned bit = (unsigned)value;
+  return bit < FILTER_MAX_VALUE + 1 ? bit : FILTER_MAX_VALUE + 1;
+}
+
+/**
+ * Check whether a household matches a compiled filter
+ *
+ * @param filter
+ * @param item
+ * @return 1 if the household matches, 0 otherwise
+ */
+static inline int matchesFilter(const household_filter *filter,
+                                const household *item) {
+  unsigned bits = 0;
+  int i;
+  for (i = 0; i < filter->count; i++) {
+    const filter_condition *condition = &filter->conditions[i];
+    int value = *(const int *)((const char *)item + condition->offset);
+    bits |= (unsigned)((condition->values >> filterValueBit(value)) & 1) << i;
+  }
+  return (int)((filter->table[bits >> 6] >> (bits & 63)) & 1);
+}
+
+/*
+ * Household fields
+ */
+int findFilterField(const char *name, size_t length);
+const char *getFilterFieldName(int field);
+size_t getFilterFieldOffset(int field);
+
+/*
+ * Compiling expressions
+ */
+int compileFilter(const char *expression, household_filter *filter);
+
+/*
+ * Filtering the linked list, the columnar store and household files
+ */
+long filterLinkedList(Node *head, const household_filter *filter,
+                      household_visitor visit, void *sink);
+long filterColumns(const household_columns *columns,
+                   const household_filter *filter, household_visitor visit,
+                   void *sink);
+long countFilteredColumns(const household_columns *columns,
+                          const household_filter *filter, int threads);
+long filterHouseholdFile(const char *fileName, const household_filter *filter,
+                         household_visitor visit, void *sink);
+
+#endif // ELMERALMEIDAASSIGN3_FILTER_H
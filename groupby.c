@@ -0,0 +1,594 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the group-by engine defined in
+ * groupby.h
+ */
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cube.h"
+#include "groupby.h"
+
+#define NUM_TOWNS_PER_REGION (TOWN_RANGE + 1)
+#define NUM_RACES (RACE_RANGE + 1)
+// household counts, sizes and tests all go from 0 to the largest household
+#define NUM_MEMBER_VALUES (HOUSEHOLD_SIZE_RANGE + HOUSEHOLD_SIZE_OFFSET + 1)
+// cells of a new hash table, doubled whenever it gets half full
+#define GROUP_HASH_CELLS 64
+
+// values every field can take, from 0
+static const unsigned fieldValues[FILTER_FIELDS] = {
+    NUM_REGIONS,       NUM_TOWNS_PER_REGION, NUM_RACES,
+    NUM_MEMBER_VALUES, NUM_MEMBER_VALUES,    NUM_MEMBER_VALUES,
+    NUM_MEMBER_VALUES, NUM_MEMBER_VALUES};
+
+static const char *measureNames[] = {"count", "sum", "min", "max", "avg"};
+
+/**
+ * Group households by the given key fields, keeping the given measures. The
+ * grouping is dense when the key has at most GROUP_DENSE_LIMIT values, hashed
+ * otherwise.
+ *
+ * @param grouping
+ * @param fields bit n set when the FILTER_ field n is part of the key
+ * @param measures
+ * @param count number of measures, up to GROUP_MAX_MEASURES
+ * @return 1 if the grouping is ready, 0 if out of memory
+ */
+int initGrouping(household_grouping *grouping, unsigned fields,
+                 const group_measure *measures, int count) {
+  long values = 1; // every key field has less than 256 values, no overflow
+  int field, i;
+
+  memset(grouping, 0, sizeof(*grouping));
+  for (field = 0; field < FILTER_FIELDS; field++) {
+    if ((fields >> field) & 1) {
+      grouping->keyFields[grouping->keyCount] = field;
+      grouping->keyValues[grouping->keyCount++] = fieldValues[field];
+      values *= fieldValues[field];
+    }
+  }
+  for (i = 0; i < count; i++)
+    grouping->measures[i] = measures[i];
+  grouping->count = count;
+
+  grouping->dense = values <= GROUP_DENSE_LIMIT;
+  if (!grouping->dense) {
+    // a hash table can take any value a byte of the key holds
+    for (i = 0; i < grouping->keyCount; i++)
+      grouping->keyValues[i] = GROUP_MAX_VALUE + 1;
+  }
+  grouping->capacity = grouping->dense ? values : GROUP_HASH_CELLS;
+  grouping->cells = calloc((size_t)grouping->capacity, sizeof(group_cell));
+  return grouping->cells != NULL;
+}
+
+/**
+ * Skip the spaces of a group-by
+ *
+ * @param ptr
+ * @return first character that isn't a space
+ */
+static const char *skipGroupSpaces(const char *ptr) {
+  while (isspace((unsigned char)*ptr))
+    ptr++;
+  return ptr;
+}
+
+/**
+ * Get the length of the word at the start of a group-by
+ *
+ * @param ptr
+ * @return number of letters, digits and underscores
+ */
+static size_t groupWordLength(const char *ptr) {
+  size_t length = 0;
+  while (isalnum((unsigned char)ptr[length]) || ptr[length] == '_')
+    length++;
+  return length;
+}
+
+/**
+ * Parse a measure -- count, or sum, min, max or avg of a field
+ *
+ * @param ptr start of the measure, moved past it
+ * @param measure where to store the measure
+ * @return NULL if the measure is valid, the error otherwise
+ */
+static const char *parseGroupMeasure(const char **ptr,
+                                     group_measure *measure) {
+  size_t length = groupWordLength(*ptr);
+  int kind;
+
+  for (kind = GROUP_COUNT; kind <= GROUP_AVG; kind++) {
+    if (length == strlen(measureNames[kind]) &&
+        strncasecmp(*ptr, measureNames[kind], length) == 0)
+      break;
+  }
+  if (kind > GROUP_AVG)
+    return "expected count, sum, min, max or avg";
+  *ptr += length;
+  measure->kind = kind;
+  measure->field = 0;
+  if (kind == GROUP_COUNT)
+    return NULL;
+
+  *ptr = skipGroupSpaces(*ptr);
+  if (**ptr != '(')
+    return "expected ( after the measure";
+  *ptr = skipGroupSpaces(*ptr + 1);
+  length = groupWordLength(*ptr);
+  measure->field = findFilterField(*ptr, length);
+  if (measure->field < 0)
+    return "expected a field name";
+  *ptr = skipGroupSpaces(*ptr + length);
+  if (**ptr != ')')
+    return "expected ) after the field";
+  (*ptr)++;
+  return NULL;
+}
+
+/**
+ * Compile a group-by -- the key fields, separated by commas, then optionally
+ * a colon and the measures, for example "region,race: count, avg(tested)".
+ * Without measures the households of every group are counted. An invalid
+ * group-by is printed with where it went wrong.
+ *
+ * @param spec
+ * @param grouping where to store the grouping, freed by freeGrouping
+ * @return 1 if the group-by is valid, 0 otherwise
+ */
+int compileGrouping(const char *spec, household_grouping *grouping) {
+  group_measure measures[GROUP_MAX_MEASURES];
+  const char *ptr = skipGroupSpaces(spec), *error = NULL;
+  unsigned fields = 0;
+  int count = 0;
+
+  if (strlen(spec) > GROUP_MAX_SPEC) {
+    printf("The group-by is longer than %d characters.\n", GROUP_MAX_SPEC);
+    return 0;
+  }
+
+  // key fields, up to the colon -- none for a single group
+  while (*ptr != ':' && *ptr != '\0') {
+    size_t length = groupWordLength(ptr);
+    int field = findFilterField(ptr, length);
+    if (field < 0) {
+      error = "expected a field name";
+      break;
+    }
+    fields |= 1u << field;
+    ptr = skipGroupSpaces(ptr + length);
+    if (*ptr == ',')
+      ptr = skipGroupSpaces(ptr + 1);
+    else if (*ptr != ':' && *ptr != '\0') {
+      error = "expected a comma, a colon or the end of the group-by";
+      break;
+    }
+  }
+
+  // measures, after the colon
+  if (error == NULL && *ptr == ':') {
+    ptr = skipGroupSpaces(ptr + 1);
+    while (*ptr != '\0') {
+      if (count == GROUP_MAX_MEASURES) {
+        error = "too many measures";
+        break;
+      }
+      error = parseGroupMeasure(&ptr, &measures[count]);
+      if (error != NULL)
+        break;
+      count++;
+      ptr = skipGroupSpaces(ptr);
+      if (*ptr == ',')
+        ptr = skipGroupSpaces(ptr + 1);
+      else if (*ptr != '\0') {
+        error = "expected a comma or the end of the group-by";
+        break;
+      }
+    }
+  }
+  if (error != NULL) {
+    printf("Invalid group-by, %s at column %d:\n%s\n%*s^\n", error,
+           (int)(ptr - spec) + 1, spec, (int)(ptr - spec), "");
+    return 0;
+  }
+
+  if (count == 0) {
+    measures[0].kind = GROUP_COUNT;
+    measures[0].field = 0;
+    count = 1;
+  }
+  if (!initGrouping(grouping, fields, measures, count)) {
+    printf("Not enough memory to group the households.\n");
+    return 0;
+  }
+  return 1;
+}
+
+/**
+ * Free the groups of a grouping
+ *
+ * @param grouping
+ */
+void freeGrouping(household_grouping *grouping) {
+  free(grouping->cells);
+  grouping->cells = NULL;
+  grouping->capacity = 0;
+  grouping->groups = 0;
+}
+
+/**
+ * Hash a key, the top bits of the product being the best mixed
+ *
+ * @param key
+ * @return hash
+ */
+static size_t hashGroupKey(uint64_t key) {
+  return (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+/**
+ * Get the cell of a key in a hash table, or the empty cell where it goes
+ *
+ * @param cells
+ * @param capacity a power of two
+ * @param key
+ * @return cell
+ */
+static group_cell *probeGroupCells(group_cell *cells, long capacity,
+                                   uint64_t key) {
+  size_t mask = (size_t)capacity - 1, slot;
+  for (slot = hashGroupKey(key) & mask;; slot = (slot + 1) & mask) {
+    if (cells[slot].households == 0 || cells[slot].key == key)
+      return &cells[slot];
+  }
+}
+
+/**
+ * Double the cells of a hash table, moving every group over
+ *
+ * @param grouping
+ * @return 1 if the table has grown, 0 if out of memory
+ */
+static int growGroupCells(household_grouping *grouping) {
+  long capacity = grouping->capacity * 2, i;
+  group_cell *cells = calloc((size_t)capacity, sizeof(group_cell));
+  if (cells == NULL)
+    return 0;
+  for (i = 0; i < grouping->capacity; i++) {
+    if (grouping->cells[i].households > 0)
+      *probeGroupCells(cells, capacity, grouping->cells[i].key) =
+          grouping->cells[i];
+  }
+  free(grouping->cells);
+  grouping->cells = cells;
+  grouping->capacity = capacity;
+  return 1;
+}
+
+/**
+ * Get the group of the values of every field, starting it if it's new
+ *
+ * @param grouping
+ * @param values of every FILTER_ field
+ * @param households with these values, skipped if a key value is out of range
+ * @return group, NULL if skipped or out of memory
+ */
+static group_cell *findGroup(household_grouping *grouping, const int *values,
+                             long households) {
+  uint64_t key = 0;
+  long index = 0;
+  group_cell *cell;
+  int i;
+
+  for (i = 0; i < grouping->keyCount; i++) {
+    unsigned value = (unsigned)values[grouping->keyFields[i]];
+    if (value >= grouping->keyValues[i]) {
+      grouping->skipped += households;
+      return NULL;
+    }
+    key = key << 8 | value;
+    index = index * grouping->keyValues[i] + value;
+  }
+
+  if (grouping->dense)
+    cell = &grouping->cells[index];
+  else {
+    // keep the table at most half full, so probes stay short
+    if ((grouping->groups + 1) * 2 > grouping->capacity &&
+        !growGroupCells(grouping)) {
+      grouping->failed = 1;
+      return NULL;
+    }
+    cell = probeGroupCells(grouping->cells, grouping->capacity, key);
+  }
+
+  if (cell->households == 0) {
+    cell->key = key;
+    for (i = 0; i < grouping->count; i++) {
+      cell->min[i] = INT_MAX;
+      cell->max[i] = INT_MIN;
+    }
+    grouping->groups++;
+  }
+  return cell;
+}
+
+/**
+ * Visitor adding a household to its group of a household_grouping, to group
+ * the households of any scan
+ *
+ * @param item
+ * @param sink household_grouping
+ */
+void groupHousehold(const household *item, void *sink) {
+  household_grouping *grouping = sink;
+  int values[FILTER_FIELDS];
+  group_cell *cell;
+  int field, i;
+
+  if (grouping->failed)
+    return;
+  for (field = 0; field < FILTER_FIELDS; field++)
+    values[field] =
+        *(const int *)((const char *)item + getFilterFieldOffset(field));
+  cell = findGroup(grouping, values, 1);
+  if (cell == NULL)
+    return;
+
+  cell->households++;
+  for (i = 0; i < grouping->count; i++) {
+    int value = values[grouping->measures[i].field];
+    cell->sum[i] += value;
+    if (value < cell->min[i])
+      cell->min[i] = value;
+    if (value > cell->max[i])
+      cell->max[i] = value;
+  }
+}
+
+/**
+ * Get the sum of a field over the households of a cube cell
+ *
+ * @param totals of the cell
+ * @param field FILTER_ field
+ * @param values of the region, town and race of the cell
+ * @return sum
+ */
+static long sumCubeField(const household_totals *totals, int field,
+                         const int *values) {
+  switch (field) {
+  case FILTER_SIZE:
+    return totals->size;
+  case FILTER_SENIORS:
+    return totals->seniors;
+  case FILTER_CHRONIC:
+    return totals->adultsWithChronicDiseases;
+  case FILTER_TESTED:
+    return totals->tested;
+  case FILTER_POSITIVE:
+    return totals->adultsTestedPositive;
+  default:
+    // region, town or race, the same for every household of the cell
+    return values[field] * totals->households;
+  }
+}
+
+/**
+ * Group the households of the linked list from the cells of the data cube,
+ * when the key only has region, town and race, and every measure is a count,
+ * a sum or an average
+ *
+ * @param grouping
+ * @return 1 if the households were grouped, 0 if the cube can't group them
+ */
+static int groupDataCube(household_grouping *grouping) {
+  unsigned cubeFields =
+      1u << FILTER_REGION | 1u << FILTER_TOWN | 1u << FILTER_RACE;
+  int values[FILTER_FIELDS] = {0};
+  int i;
+
+  for (i = 0; i < grouping->keyCount; i++) {
+    if (!((cubeFields >> grouping->keyFields[i]) & 1))
+      return 0;
+  }
+  for (i = 0; i < grouping->count; i++) {
+    if (grouping->measures[i].kind == GROUP_MIN ||
+        grouping->measures[i].kind == GROUP_MAX)
+      return 0;
+  }
+
+  for (values[FILTER_REGION] = 0; values[FILTER_REGION] < NUM_REGIONS;
+       values[FILTER_REGION]++) {
+    for (values[FILTER_TOWN] = 0; values[FILTER_TOWN] < NUM_TOWNS_PER_REGION;
+         values[FILTER_TOWN]++) {
+      for (values[FILTER_RACE] = 0; values[FILTER_RACE] < NUM_RACES;
+           values[FILTER_RACE]++) {
+        household_totals totals = rollupCube(
+            values[FILTER_REGION], values[FILTER_TOWN], values[FILTER_RACE]);
+        group_cell *cell;
+        if (totals.households == 0)
+          continue;
+        cell = findGroup(grouping, values, totals.households);
+        if (cell == NULL)
+          continue;
+        cell->households += totals.households;
+        for (i = 0; i < grouping->count; i++)
+          cell->sum[i] +=
+              sumCubeField(&totals, grouping->measures[i].field, values);
+      }
+    }
+  }
+  return 1;
+}
+
+/**
+ * Group every household of the linked list into an empty grouping. A key of
+ * region, town and race with counts, sums and averages is rolled up from the
+ * 30 cells of the data cube; any other grouping scans the list.
+ *
+ * @param head
+ * @param grouping
+ * @return 1 if the households were grouped, 0 if out of memory
+ */
+int groupLinkedList(Node *head, household_grouping *grouping) {
+  if (!groupDataCube(grouping)) {
+    household_predicate predicate = anyHousehold();
+    scanLinkedList(head, &predicate, groupHousehold, grouping);
+  }
+  return !grouping->failed;
+}
+
+/**
+ * Compare two groups by key, for qsort
+ *
+ * @param a
+ * @param b
+ * @return negative, 0 or positive
+ */
+static int compareGroups(const void *a, const void *b) {
+  uint64_t keyA = ((const group_cell *)a)->key;
+  uint64_t keyB = ((const group_cell *)b)->key;
+  return (keyA > keyB) - (keyA < keyB);
+}
+
+/**
+ * Move the groups to the first cells of a grouping, in key order. No more
+ * households can be grouped afterwards.
+ *
+ * @param grouping
+ * @return number of groups, in cells 0 to groups - 1
+ */
+long orderGroups(household_grouping *grouping) {
+  long from, to = 0;
+  for (from = 0; from < grouping->capacity; from++) {
+    if (grouping->cells[from].households > 0)
+      grouping->cells[to++] = grouping->cells[from];
+  }
+  // a dense array is already in key order, a hash table isn't
+  if (!grouping->dense)
+    qsort(grouping->cells, (size_t)to, sizeof(group_cell), compareGroups);
+  grouping->capacity = to;
+  return to;
+}
+
+/**
+ * Get the value of a key field of a group
+ *
+ * @param grouping
+ * @param cell of the group
+ * @param field FILTER_ field
+ * @return value, -1 if the field isn't part of the key
+ */
+int getGroupKey(const household_grouping *grouping, const group_cell *cell,
+                int field) {
+  int i;
+  for (i = 0; i < grouping->keyCount; i++) {
+    if (grouping->keyFields[i] == field)
+      return (int)((cell->key >> 8 * (grouping->keyCount - 1 - i)) & 0xff);
+  }
+  return -1;
+}
+
+/**
+ * Get a measure of a group
+ *
+ * @param grouping
+ * @param cell of the group
+ * @param measure index of the measure in the grouping
+ * @return value of the measure
+ */
+double getGroupMeasure(const household_grouping *grouping,
+                       const group_cell *cell, int measure) {
+  switch (grouping->measures[measure].kind) {
+  case GROUP_COUNT:
+    return (double)cell->households;
+  case GROUP_SUM:
+    return (double)cell->sum[measure];
+  case GROUP_MIN:
+    return cell->min[measure];
+  case GROUP_MAX:
+    return cell->max[measure];
+  default:
+    return (double)cell->sum[measure] / cell->households;
+  }
+}
+
+/**
+ * Print the value of a key field of a group, by name for a region, a race, or
+ * a town of a known region
+ *
+ * @param grouping
+ * @param cell of the group
+ * @param field FILTER_ field
+ */
+static void printGroupKey(const household_grouping *grouping,
+                          const group_cell *cell, int field) {
+  int value = getGroupKey(grouping, cell, field);
+  int region = getGroupKey(grouping, cell, FILTER_REGION);
+  if (field == FILTER_REGION)
+    printf("%18s", displayRegion(value));
+  else if (field == FILTER_TOWN && region >= 0)
+    printf("%18s", displayTown(region, value));
+  else if (field == FILTER_RACE)
+    printf("%18s", displayRace(value));
+  else
+    printf("%18d", value);
+}
+
+/**
+ * Print every group of a grouping in key order, one per row with its key and
+ * its measures. The grouping is ordered by orderGroups first.
+ *
+ * @param grouping
+ */
+void printGroups(household_grouping *grouping) {
+  char label[32];
+  long groups, g;
+  int i;
+
+  if (grouping->failed) {
+    printf("Not enough memory to group the households.\n");
+    return;
+  }
+  groups = orderGroups(grouping);
+
+  for (i = 0; i < grouping->keyCount; i++)
+    printf("%18s", getFilterFieldName(grouping->keyFields[i]));
+  for (i = 0; i < grouping->count; i++) {
+    const group_measure *measure = &grouping->measures[i];
+    if (measure->kind == GROUP_COUNT)
+      snprintf(label, sizeof(label), "%s", measureNames[measure->kind]);
+    else
+      snprintf(label, sizeof(label), "%s(%s)", measureNames[measure->kind],
+               getFilterFieldName(measure->field));
+    printf("%18s", label);
+  }
+  puts("");
+
+  for (g = 0; g < groups; g++) {
+    const group_cell *cell = &grouping->cells[g];
+    for (i = 0; i < grouping->keyCount; i++)
+      printGroupKey(grouping, cell, grouping->keyFields[i]);
+    for (i = 0; i < grouping->count; i++) {
+      if (grouping->measures[i].kind == GROUP_AVG)
+        printf("%18.2f", getGroupMeasure(grouping, cell, i));
+      else
+        printf("%18.0f", getGroupMeasure(grouping, cell, i));
+    }
+    puts("");
+  }
+  printf("Number of groups: %ld (%s)\n", groups,
+         grouping->dense ? "dense array" : "hash table");
+  if (grouping->skipped > 0)
+    printf("%ld households with a key value out of range were left out.\n",
+           grouping->skipped);
+  puts("");
+}
@@ -0,0 +1,88 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the group-by engine, for example
+ * "region,race: count, sum(positive), avg(tested)".
+ *
+ * Households are grouped by a key made of any of their fields, and every group
+ * keeps the measures asked for: the number of households, and the sum, the
+ * minimum, the maximum or the average of a field. A key with few possible
+ * values is grouped into a dense array indexed by the key, any other into an
+ * open-addressing hash table.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_GROUPBY_H
+#define ELMERALMEIDAASSIGN3_GROUPBY_H
+
+#include <stdint.h>
+
+#include "filter.h"
+#include "scan.h"
+
+// measures of a group
+#define GROUP_COUNT 0
+#define GROUP_SUM 1
+#define GROUP_MIN 2
+#define GROUP_MAX 3
+#define GROUP_AVG 4
+
+#define GROUP_MAX_MEASURES 8
+#define GROUP_MAX_SPEC 255
+// keys with up to this many possible values are grouped into a dense array
+#define GROUP_DENSE_LIMIT 4096
+// a key field takes a byte of the key, the hash table can't group past it
+#define GROUP_MAX_VALUE 255
+
+typedef struct group_measure {
+  int kind;  // GROUP_ measure
+  int field; // FILTER_ field measured, unused by GROUP_COUNT
+} group_measure;
+
+typedef struct group_cell {
+  uint64_t key;    // a byte per key field, the first field in the top one
+  long households; // 0 while the cell holds no group
+  long sum[GROUP_MAX_MEASURES];
+  int min[GROUP_MAX_MEASURES];
+  int max[GROUP_MAX_MEASURES];
+} group_cell;
+
+typedef struct household_grouping {
+  int keyFields[FILTER_FIELDS]; // FILTER_ fields of the key, in field order
+  int keyCount;
+  unsigned keyValues[FILTER_FIELDS]; // values each key field can take
+  group_measure measures[GROUP_MAX_MEASURES];
+  int count;       // number of measures
+  int dense;       // 1 for a dense array, 0 for a hash table
+  group_cell *cells;
+  long capacity;   // cells, a power of two for a hash table
+  long groups;     // cells holding a group
+  long skipped;    // households with a key value out of range
+  int failed;      // set when the hash table ran out of memory
+} household_grouping;
+
+/*
+ * Grouping administration
+ */
+int initGrouping(household_grouping *grouping, unsigned fields,
+                 const group_measure *measures, int count);
+int compileGrouping(const char *spec, household_grouping *grouping);
+void freeGrouping(household_grouping *grouping);
+
+/*
+ * Grouping households
+ */
+void groupHousehold(const household *item, void *sink);
+int groupLinkedList(Node *head, household_grouping *grouping);
+long orderGroups(household_grouping *grouping);
+
+/*
+ * Reading the groups
+ */
+int getGroupKey(const household_grouping *grouping, const group_cell *cell,
+                int field);
+double getGroupMeasure(const household_grouping *grouping,
+                       const group_cell *cell, int measure);
+void printGroups(household_grouping *grouping);
+
+#endif // ELMERALMEIDAASSIGN3_GROUPBY_H
@@ -6,22 +6,66 @@
  * defined in linkedlist.h
  */
 
+#include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "linkedlist.h"
+#include "nodepool.h"
+#include "packed.h"
+#include "bitmapindex.h"
+#include "cube.h"
+#include "groupby.h"
+#include "scan.h"
+#include "topk.h"
+#include "tripletindex.h"
+
+/**
+ * Add a node to every index kept on the linked list
+ *
+ * @param node added to the list
+ */
+static void trackNode(Node *node) {
+  household item = getNodeHousehold(node);
+  indexTripletNode(node); // add the node to its region, town and race bucket
+  indexBitmapNode(node);  // set its id in the region, town and race bitmaps
+  addToCube(item);        // add it to its region, town and race cell
+  addNodeToZone(node);    // and to the zone map of its block of nodes
+}
+
+/**
+ * Remove a node from the indexes that don't drop it themselves and give it
+ * back to the node pool
+ *
+ * @param node deleted from the list
+ */
+static void untrackNode(Node *node) {
+  household item = getNodeHousehold(node);
+  unindexBitmapNode(node);
+  removeFromCube(item);
+  releaseNode(node); // give the memory back to the node pool
+}
 
 /**
  * Method to create a first node of the linked list
  *
  * @param num to add to the node of the linked list first element
- * @return the first linked list node created
+ * @return the first linked list node created, NULL if out of memory or if the
+ * household doesn't fit a packed record
  */
 Node *makeNode(household item) {
-  Node *ptr = malloc(sizeof(*ptr)); // allocate memory
-  ptr->item = item;                 // add the household item to the linked list
-  ptr->next = NULL;                 // make sure its the head of the list
+  packed_household packed;
+  Node *ptr;
+  if (!encodeHousehold(item, &packed))
+    return NULL;
+  ptr = allocateNode(); // allocate memory from the node pool
+  if (ptr == NULL)
+    return NULL;
+  ptr->packed = packed; // add the household item to the linked list
+  ptr->next = NULL;           // make sure its the head of the list
+  ptr->prev = NULL;
+  trackNode(ptr);
   return ptr;
 }
 
@@ -30,14 +74,57 @@ Node *makeNode(household item) {
  *
  * @param top node reference of the linked list
  * @param num value to add to the node
+ * @return 1 if the node has been added, 0 if out of memory or if the household
+ * doesn't fit a packed record
  */
-void addNode(NodePtr *head, household item) {
-  NodePtr ptr =
-      malloc(sizeof(*ptr)); // allocate space for the new linked list node
-  ptr->item = item;    // add the new household information to the linked list
+int addNode(NodePtr *head, household item) {
+  packed_household packed;
+  NodePtr ptr;
+  if (!encodeHousehold(item, &packed))
+    return 0;
+  ptr = allocateNode(); // take the new linked list node from the pool
+  if (ptr == NULL)
+    return 0; // the list is left as it was
+  ptr->packed = packed; // add the new household information to the linked list
   ptr->next = (*head); // the new node will be the new head, ensure the
                        // connection to the previous head
-  (*head) = ptr;       // new node to head
+  ptr->prev = NULL;
+  if (*head != NULL)
+    (*head)->prev = ptr; // link the previous head back to the new node
+  (*head) = ptr;         // new node to head
+  trackNode(ptr);
+  return 1;
+}
+
+/**
+ * Unlink a node from the linked list without walking the list
+ *
+ * @param head
+ * @param node to unlink
+ */
+static void unlinkNode(NodePtr *head, Node *node) {
+  // the node before it, or the head, now skips over the node
+  if (node->prev != NULL)
+    node->prev->next = node->next;
+  else
+    *head = node->next;
+  // the node after it points back past the node
+  if (node->next != NULL)
+    node->next->prev = node->prev;
+}
+
+/**
+ * Release every node of the linked list at once and empty the indexes kept on
+ * it.
+ *
+ * @param head
+ */
+void freeLinkedList(NodePtr *head) {
+  clearTripletIndex();
+  clearBitmapIndex();
+  clearCube();
+  releaseNodePool();
+  *head = NULL;
 }
 
 /**
@@ -51,7 +138,7 @@ void printLinkedList(Node *head) {
   printHouseholdItemHeader();
   // iterate through entire linked list
   while (ptr != NULL) {
-    printHouseholdItem(++ctr, ptr->item);
+    printHouseholdItem(++ctr, getNodeHousehold(ptr));
     ptr = ptr->next; // next item
   }
   // print format
@@ -65,28 +152,39 @@ void printLinkedList(Node *head) {
 }
 
 /**
- * Print linked list by provided region
+ * Print the households of the linked list matching a predicate. When the
+ * bitmap indexes already know how many households match, that number is
+ * reported and the list isn't walked at all for a listing without households.
  *
  * @param head
- * @param region
+ * @param predicate
+ * @param households number of matching households, -1 to count them as they
+ * are printed
  */
-void printLinkedListByRegion(Node *head, int region) {
-  Node *ptr = head;
-  int ctr = 0;
+static void printLinkedListMatching(Node *head,
+                                    const household_predicate *predicate,
+                                    long households) {
+  int ctr = 0; // keep track of number of records
   printHouseholdItemHeader();
-  // iterate through entire linked list
-  while (ptr != NULL) {
-    // check if the region matches
-    if (ptr->item.region == region)
-      printHouseholdItem(
-          ++ctr, ptr->item); // only print out the matching household item
-    ptr = ptr->next;
-  }
+  if (households != 0)
+    scanLinkedList(head, predicate, printMatchingHousehold, &ctr);
   printHouseholdItemSeparator();
-  printf("Number of records: %d\n", ctr);
+  printf("Number of records: %ld\n", households >= 0 ? households : ctr);
   puts("");
 }
 
+/**
+ * Print linked list by provided region
+ *
+ * @param head
+ * @param region
+ */
+void printLinkedListByRegion(Node *head, int region) {
+  household_predicate predicate = anyHousehold();
+  predicate.region = region;
+  printLinkedListMatching(head, &predicate, countHouseholdsByRegion(region));
+}
+
 /**
  * Print linked list by provided town
  *
@@ -94,64 +192,218 @@ void printLinkedListByRegion(Node *head, int region) {
  * @param town
  */
 void printLinkedListByTown(Node *head, int region, int town) {
-  Node *ptr = head;
-  int ctr = 0; // keep track of number of records
+  household_predicate predicate = anyHousehold();
+  predicate.region = region;
+  predicate.town = town;
+  printLinkedListMatching(head, &predicate,
+                          countHouseholdsByTown(region, town));
+}
+
+/**
+ * Print link list data by provided race
+ *
+ * @param head
+ * @param race
+ */
+void printLinkedListByRace(Node *head, int race) {
+  household_predicate predicate = anyHousehold();
+  predicate.race = race;
+  printLinkedListMatching(head, &predicate, countHouseholdsByRace(race));
+}
+
+/**
+ * Display the number of adults tested positive in a specified region with the
+ * minimum tested positive as a filter. The blocks of nodes whose zone maps
+ * rule out the region or hold too few positives are skipped, and their number
+ * is printed along with the records.
+ *
+ * @param region
+ * @param minTestedPositive
+ */
+void printLinkedListByRegionWithMinTestedPositive(int region,
+                                                  int minTestedPositive) {
+  household_predicate predicate = anyHousehold();
+  household_collection listing = {0};
+  long pruned = getBlocksPruned(), i;
+
+  predicate.region = region;
+  predicate.minTestedPositive = minTestedPositive;
+  if (!collectLinkedList(&predicate, &listing)) {
+    printf("Not enough memory to list the households.\n\n");
+    freeHouseholdCollection(&listing);
+    return;
+  }
+
   printHouseholdItemHeader();
-  while (ptr != NULL) {
-    // check to find the matching town (with region)
-    if (ptr->item.region == region && ptr->item.town == town)
-      printHouseholdItem(++ctr, ptr->item);
-    ptr = ptr->next; // iterate over to the next node
+  for (i = 0; i < listing.count; i++)
+    printHouseholdItem((int)i + 1, listing.items[i]);
+  printHouseholdItemSeparator();
+  printf("Number of records: %ld\n", listing.count);
+  printf("Blocks skipped by their zone maps: %ld\n",
+         getBlocksPruned() - pruned);
+  puts("");
+  freeHouseholdCollection(&listing);
+}
+
+/**
+ * Print the households of a listing collected by a batch scan, or scan the
+ * linked list again for them if the collection ran out of memory
+ *
+ * @param head
+ * @param predicate of the listing
+ * @param listing households collected by the batch scan
+ */
+static void printCollectedHouseholds(Node *head,
+                                     const household_predicate *predicate,
+                                     const household_collection *listing) {
+  long i;
+  if (listing->failed) {
+    printLinkedListMatching(head, predicate, -1);
+    return;
   }
+  printHouseholdItemHeader();
+  for (i = 0; i < listing->count; i++)
+    printHouseholdItem((int)i + 1, listing->items[i]);
   printHouseholdItemSeparator();
-  printf("Number of records: %d\n", ctr);
+  printf("Number of records: %ld\n", listing->count);
   puts("");
 }
 
 /**
- * Print link list data by provided race
+ * Print the listings of a report -- the households of a region, of a race, and
+ * of the region with a minimum tested positive -- from a single scan of the
+ * linked list. Every listing is collected during the scan and printed once it
+ * is done, in the same order as its own listing would print it.
  *
  * @param head
+ * @param region
  * @param race
+ * @param minTestedPositive
  */
-void printLinkedListByRace(Node *head, int race) {
-  Node *ptr = head;
-  int ctr = 0;
+void printLinkedListReport(Node *head, int region, int race,
+                           int minTestedPositive) {
+  household_predicate byRegion = anyHousehold(), byRace = anyHousehold(),
+                      byPositive = anyHousehold();
+  household_collection regionListing = {0}, raceListing = {0},
+                       positiveListing = {0};
+  scan_batch batch;
+
+  byRegion.region = region;
+  byRace.race = race;
+  byPositive.region = region;
+  byPositive.minTestedPositive = minTestedPositive;
+
+  initScanBatch(&batch);
+  addScanQuery(&batch, &byRegion, collectHousehold, &regionListing);
+  addScanQuery(&batch, &byRace, collectHousehold, &raceListing);
+  addScanQuery(&batch, &byPositive, collectHousehold, &positiveListing);
+  scanLinkedListBatch(head, &batch);
+
+  printf("Records with region: %s.\n", displayRegion(region));
+  printCollectedHouseholds(head, &byRegion, &regionListing);
+  printf("Records with race: %s.\n", displayRace(race));
+  printCollectedHouseholds(head, &byRace, &raceListing);
+  printf("Records with region: %s and at least %d tested positive.\n",
+         displayRegion(region), minTestedPositive);
+  printCollectedHouseholds(head, &byPositive, &positiveListing);
+
+  freeHouseholdCollection(&regionListing);
+  freeHouseholdCollection(&raceListing);
+  freeHouseholdCollection(&positiveListing);
+}
+
+/**
+ * Print the households of the linked list matching a compiled filter
+ * expression
+ *
+ * @param head
+ * @param filter
+ */
+void printLinkedListByFilter(Node *head, const household_filter *filter) {
+  int ctr = 0; // keep track of number of records
   printHouseholdItemHeader();
-  // iterate through the linked list
-  while (ptr != NULL) {
-    // check to see if the rece matches
-    if (ptr->item.race == race)
-      printHouseholdItem(++ctr, ptr->item); // only print the matched results
-    ptr = ptr->next;                        // move onto the next node
-  }
+  filterLinkedList(head, filter, printMatchingHousehold, &ctr);
   printHouseholdItemSeparator();
   printf("Number of records: %d\n", ctr);
   puts("");
 }
 
 /**
- * Display the number of adults tested positive in a specified region with the
- * minimum tested positive as a filter
+ * Print the K households of a region that rank highest, by most adults tested
+ * positive or by the highest share of the tested adults positive, best first.
+ * Only K households are kept while the node pool is scanned.
+ *
+ * @param region
+ * @param order TOPK_POSITIVE or TOPK_RATIO
+ * @param k number of households to print
+ */
+void printLinkedListTopByRegion(int region, int order, long k) {
+  household_predicate predicate = anyHousehold();
+  household *top;
+  long count, i;
+
+  predicate.region = region;
+  top = malloc(sizeof(household) * (size_t)k);
+  count = top != NULL ? topLinkedList(&predicate, order, k, top) : -1;
+  if (count < 0) {
+    printf("Not enough memory to find the top households.\n\n");
+    free(top);
+    return;
+  }
+
+  printHouseholdItemHeader();
+  for (i = 0; i < count; i++)
+    printHouseholdItem((int)i + 1, top[i]);
+  printHouseholdItemSeparator();
+  printf("Number of records: %ld\n", count);
+  puts("");
+  free(top);
+}
+
+/**
+ * Count the households of a region with the minimum tested positive as a
+ * filter, the same households printLinkedListByRegionWithMinTestedPositive
+ * prints. The order doesn't matter to a count, so the node pool is counted
+ * from several threads instead of walking the list.
  *
- * @param head
  * @param region
  * @param minTestedPositive
+ * @return number of matching households
  */
-void printLinkedListByRegionWithMinTestedPositive(Node *head, int region,
+long countLinkedListByRegionWithMinTestedPositive(int region,
                                                   int minTestedPositive) {
-  Node *ptr = head;
-  int ctr = 0; // keep track of all the records
+  household_predicate predicate = anyHousehold();
+  predicate.region = region;
+  predicate.minTestedPositive = minTestedPositive;
+  return countLinkedList(&predicate);
+}
+
+/**
+ * Print the households of a region, town and race triplet. Only the nodes of
+ * the triplet are visited, through the triplet index.
+ *
+ * @param head
+ * @param region
+ * @param town
+ * @param race
+ */
+void printLinkedListByRegionTownRace(Node *head, int region, int town,
+                                     int race) {
+  Node *ptr;
+  int ctr = 0; // keep track of number of records
   printHouseholdItemHeader();
-  // iterate through entire linked list
-  while (ptr != NULL) {
-    // check for matching region with minimum test positives amongst adults (not
-    // seniors)
-    if (ptr->item.region == region &&
-        ptr->item.adultsTestedPositive >= minTestedPositive)
-      printHouseholdItem(++ctr,
-                         ptr->item); // only print out the matching results
-    ptr = ptr->next;                 // go to next node
+  if (isIndexedTriplet(region, town, race)) {
+    // the triplet chain is newest first, like the linked list
+    for (ptr = getTripletNodes(region, town, race); ptr != NULL;
+         ptr = ptr->tripletNext)
+      printHouseholdItem(++ctr, getNodeHousehold(ptr));
+  } else {
+    // a triplet the index doesn't keep -- go through entire linked list
+    for (ptr = head; ptr != NULL; ptr = ptr->next) {
+      household item = getNodeHousehold(ptr);
+      if (item.region == region && item.town == town && item.race == race)
+        printHouseholdItem(++ctr, item);
+    }
   }
   printHouseholdItemSeparator();
   printf("Number of records: %d\n", ctr);
@@ -159,160 +411,164 @@ void printLinkedListByRegionWithMinTestedPositive(Node *head, int region,
 }
 
 /**
- * Calculate the number of positive tested cases based on region
+ * Sum the adults tested positive of every group of a key through the group-by
+ * engine, which rolls them up from the data cube without walking the list
  *
  * @param head
- * @param region structure
+ * @param fields region, or region and town, as FILTER_ field bits
+ * @param cases where to store the sum of every group, by region, or by region
+ * and town
+ * @return 1 if the cases were summed, 0 if out of memory
  */
-void rankPositiveTestedBasedOnRegion(Node *head, rank_cases *region) {
-  Node *ptr = head;
-  int peelPositiveCases = 0, yorkPositiveCases = 0, durhamPositiveCases = 0;
-
-  // go through entire linked list
-  while (ptr != NULL) {
-    // Peel (0) York (1) Durham (2) - check the value of region
-    switch (ptr->item.region) {
-    case 0:
-      // Peel - add to peel sum
-      peelPositiveCases += ptr->item.adultsTestedPositive;
-      break;
-    case 1:
-      // York - add to york sum
-      yorkPositiveCases += ptr->item.adultsTestedPositive;
-      break;
-    case 2:
-      // Durham - add to durham sum
-      durhamPositiveCases += ptr->item.adultsTestedPositive;
-      break;
-    default:
-      break;
-    }
-    ptr = ptr->next; // go to next node
+static int sumPositiveByGroup(Node *head, unsigned fields, rank_cases *cases) {
+  group_measure positive = {GROUP_SUM, FILTER_POSITIVE};
+  household_grouping grouping;
+  long groups, g;
+
+  if (!initGrouping(&grouping, fields, &positive, 1))
+    return 0;
+  if (!groupLinkedList(head, &grouping)) {
+    freeGrouping(&grouping);
+    return 0;
   }
-  // Peel -- add the name and cases to a structure for further manipulation
-  region[0].name = "Peel";
-  region[0].cases = peelPositiveCases;
+  groups = orderGroups(&grouping);
+  for (g = 0; g < groups; g++) {
+    const group_cell *cell = &grouping.cells[g];
+    int region = getGroupKey(&grouping, cell, FILTER_REGION);
+    int town = getGroupKey(&grouping, cell, FILTER_TOWN);
+    cases[town < 0 ? region : region * (TOWN_RANGE + 1) + town].cases =
+        cell->sum[0];
+  }
+  freeGrouping(&grouping);
+  return 1;
+}
 
-  // York -- add the name and cases to a structure for further manipulation
-  region[1].name = "York";
-  region[1].cases = yorkPositiveCases;
+#ifdef VERIFY_AGGREGATES
+/**
+ * Recount the positive tested cases of a ranking by walking the linked list
+ * and check them against the cases the ranking read -- only built with
+ * VERIFY_AGGREGATES
+ *
+ * @param head
+ * @param cases by region, or by region and town
+ * @param byTown 1 if the cases are by region and town, 0 by region
+ */
+static void verifyRankCases(Node *head, const rank_cases *cases, int byTown) {
+  long recount[NUM_TOWNS] = {0};
+  Node *ptr;
+  int i;
+
+  for (ptr = head; ptr != NULL; ptr = ptr->next) {
+    household item = getNodeHousehold(ptr);
+    // households with an unknown region or town are in no ranking
+    if (item.region < 0 || item.region >= NUM_REGIONS ||
+        (byTown && (item.town < 0 || item.town > TOWN_RANGE)))
+      continue;
+    recount[byTown ? item.region * (TOWN_RANGE + 1) + item.town
+                   : item.region] += item.adultsTestedPositive;
+  }
+  for (i = 0; i < (byTown ? NUM_TOWNS : NUM_REGIONS); i++)
+    assert(cases[i].cases == recount[i]);
+  (void)recount; // only read by the assert
+}
+#endif
 
-  // Durham -- add the name and cases to a structure for further manipulation
-  region[2].name = "Durham";
-  region[2].cases = durhamPositiveCases;
+/**
+ * Calculate the number of positive tested cases based on region, grouping the
+ * households by region. A region without households has no cases.
+ *
+ * @param head
+ * @param region structure
+ */
+void rankPositiveTestedBasedOnRegion(Node *head, rank_cases *region) {
+  int i;
+  // Peel (0) York (1) Durham (2) -- add the name and cases to a structure for
+  // further manipulation
+  for (i = 0; i < NUM_REGIONS; i++) {
+    region[i].name = displayRegion(i);
+    region[i].cases = 0;
+  }
+  if (!sumPositiveByGroup(head, 1u << FILTER_REGION, region)) {
+    // no memory for the grouping -- roll the regions up from the cube instead
+    for (i = 0; i < NUM_REGIONS; i++)
+      region[i].cases =
+          rollupCube(i, CUBE_ALL, CUBE_ALL).adultsTestedPositive;
+  }
+#ifdef VERIFY_AGGREGATES
+  verifyRankCases(head, region, 0); // recount the cases that get printed
+#endif
 }
 
 /**
- * Calculate the positive tested cases based on town
+ * Calculate the positive tested cases based on town, grouping the households
+ * by region and town. A town without households has no cases.
  *
  * @param head
  * @param town structure
  */
 void rankPositiveTestedBasedOnTown(Node *head, rank_cases *town) {
-  Node *ptr = head;
-
-  // keep track of cases by city
-  int bramptonCases = 0, mississaugaCases = 0, mapleCases = 0, vaughanCases = 0,
-      whitbyCases = 0, oshawaCases = 0;
-
-  // go through entire linked list
-  while (ptr != NULL) {
-    switch (ptr->item.region) {
-    case 0:
-      // Peel
-      switch (ptr->item.town) {
-      case 0:
-        // Brampton - add cases to the overall for the respective city
-        bramptonCases += ptr->item.adultsTestedPositive;
-        break;
-      case 1:
-        // Mississauga - add cases to the overall for the respective city
-        mississaugaCases += ptr->item.adultsTestedPositive;
-        break;
-      default:
-        break;
-      }
-      break;
-    case 1:
-      // York
-      switch (ptr->item.town) {
-      case 0:
-        // Maple - add cases to the overall for the respective city
-        mapleCases += ptr->item.adultsTestedPositive;
-        break;
-      case 1:
-        // Vaughan - add cases to the overall for the respective city
-        vaughanCases += ptr->item.adultsTestedPositive;
-        break;
-      default:
-        break;
-      }
-      break;
-    case 2:
-      // Durham
-      switch (ptr->item.town) {
-      case 0:
-        // Whitby - add cases to the overall for the respective city
-        whitbyCases += ptr->item.adultsTestedPositive;
-        break;
-      case 1:
-        // Oshawa - add cases to the overall for the respective city
-        oshawaCases += ptr->item.adultsTestedPositive;
-        break;
-      default:
-        break;
-      }
-      break;
-    default:
-      break;
-    }
-    ptr = ptr->next; // go to next node
+  int i;
+  // Brampton, Mississauga, Maple, Vaughan, Whitby, Oshawa -- add the town data
+  // to a structure for further manipulation (sorting based on cases)
+  for (i = 0; i < NUM_TOWNS; i++) {
+    int regionNumber = i / (TOWN_RANGE + 1), townNumber = i % (TOWN_RANGE + 1);
+    town[i].name = displayTown(regionNumber, townNumber);
+    town[i].cases = 0;
   }
-
-  // all all town data to a structure for further manipulation (sorting based on
-  // cases)
-  town[0].name = "Brampton";
-  town[0].cases = bramptonCases;
-
-  town[1].name = "Mississauga";
-  town[1].cases = mississaugaCases;
-
-  town[2].name = "Maple";
-  town[2].cases = mapleCases;
-
-  town[3].name = "Vaughan";
-  town[3].cases = vaughanCases;
-
-  town[4].name = "Whitby";
-  town[4].cases = whitbyCases;
-
-  town[5].name = "Oshawa";
-  town[5].cases = oshawaCases;
+  if (!sumPositiveByGroup(head, 1u << FILTER_REGION | 1u << FILTER_TOWN,
+                          town)) {
+    // no memory for the grouping -- roll the towns up from the cube instead
+    for (i = 0; i < NUM_TOWNS; i++)
+      town[i].cases = rollupCube(i / (TOWN_RANGE + 1), i % (TOWN_RANGE + 1),
+                                 CUBE_ALL)
+                          .adultsTestedPositive;
+  }
+#ifdef VERIFY_AGGREGATES
+  verifyRankCases(head, town, 1); // recount the cases that get printed
+#endif
 }
 
 /**
- * Delete linked list items based on user specified arguments
+ * Delete linked list items based on user specified arguments. The nodes of the
+ * triplet are found through the triplet index, so only the matching nodes are
+ * visited.
  *
  * @param region
  * @param town
  * @param race
  */
 void deleteLinkedListItem(NodePtr *head, int region, int town, int race) {
-  // go through entire linked list
-  while (*head != NULL) {
-    // check if the node matches up with the region, town and race
-    if ((*head)->item.region == region && (*head)->item.town == town &&
-        (*head)->item.race == race) {
-      // temp node to store the head
-      Node *tmp = *head;
-      // move head to the next node
-      *head = (*head)->next;
-      // free the memory of the previous head
-      free(tmp);
-    } else {
-      // move onto next node
-      head = &(*head)->next;
+  Node *ptr;
+
+  // a triplet the index doesn't keep -- go through entire linked list
+  if (!isIndexedTriplet(region, town, race)) {
+    while (*head != NULL) {
+      household item = getNodeHousehold(*head);
+      // check if the node matches up with the region, town and race
+      if (item.region == region && item.town == town && item.race == race) {
+        // temp node to store the head
+        Node *tmp = *head;
+        // move head to the next node
+        *head = (*head)->next;
+        if (*head != NULL)
+          (*head)->prev = tmp->prev;
+        // drop the previous head from the indexes and free its memory
+        untrackNode(tmp);
+      } else {
+        // move onto next node
+        head = &(*head)->next;
+      }
     }
+    return;
+  }
+
+  // take the whole triplet bucket and unlink its nodes one by one
+  ptr = takeTripletNodes(region, town, race);
+  while (ptr != NULL) {
+    Node *tmp = ptr;
+    ptr = ptr->tripletNext;
+    unlinkNode(head, tmp);
+    untrackNode(tmp);
   }
 }
 
@@ -325,7 +581,7 @@ void storeDataToFile(Node *head) {
   Node *ptr = head;
   char fileName[25]; // user input for file name
   FILE *file;        // file pointer
-  int ctr = 0;       // number of records being written to the file
+  long ctr = 0;      // number of records being written to the file
 
   // clean out buffer
   while (getchar() != '\n')
@@ -351,21 +607,17 @@ void storeDataToFile(Node *head) {
 
   // add a header to the file corresponding with the data meant to view in that
   // column
-  fprintf(file, "%5s\t%7s\t%16s\t%20s\t%20s\t%10s\t%15s\n", "S.no", "Size",
-          "Total Tested", "Total Tested Positive", "Race", "Region", "Town");
+  writeHouseholdHeader(file);
 
   // loop through linked list and add each line to the file
   while (ptr != NULL) {
     // output data to the file
-    fprintf(file, "%5d\t%7d\t%16d\t%20d\t%20s\t%10s\t%15s\n", ++ctr,
-            ptr->item.size, ptr->item.tested, ptr->item.adultsTestedPositive,
-            displayRace(ptr->item.race), displayRegion(ptr->item.region),
-            displayTown(ptr->item.region, ptr->item.town));
+    writeHouseholdRecord(file, ++ctr, getNodeHousehold(ptr));
     ptr = ptr->next; // go to the next node in the linked list
   }
 
   // display stats to the console
-  printf("%d records have been written to the file: %s\n\n", ctr, fileName);
+  printf("%ld records have been written to the file: %s\n\n", ctr, fileName);
 
   // close file
   fclose(file);
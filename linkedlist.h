@@ -9,13 +9,15 @@
 #define ELMERALMEIDAASSIGN3_LINKEDLIST_H
 
 #include "almeielm.h"
+#include "filter.h"
 
 /*
  * Linked list administration
  */
 Node *makeNode(household item);
-void addNode(NodePtr *head, household item);
+int addNode(NodePtr *head, household item);
 void deleteLinkedListItem(NodePtr *head, int region, int town, int race);
+void freeLinkedList(NodePtr *head);
 
 /*
  * Printing options on the linked list
@@ -24,7 +26,20 @@ void printLinkedList(Node *head);
 void printLinkedListByRegion(Node *head, int region);
 void printLinkedListByTown(Node *head, int region, int town);
 void printLinkedListByRace(Node *head, int race);
-void printLinkedListByRegionWithMinTestedPositive(Node *head, int region,
+void printLinkedListByFilter(Node *head, const household_filter *filter);
+void printLinkedListReport(Node *head, int region, int race,
+                           int minTestedPositive);
+void printLinkedListByRegionTownRace(Node *head, int region, int town,
+                                     int race);
+
+/*
+ * Options read from the node pool, which only ever holds the nodes of the
+ * linked list -- there is a single list at a time
+ */
+void printLinkedListByRegionWithMinTestedPositive(int region,
+                                                  int minTestedPositive);
+void printLinkedListTopByRegion(int region, int order, long k);
+long countLinkedListByRegionWithMinTestedPositive(int region,
                                                   int minTestedPositive);
 
 /*
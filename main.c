@@ -9,30 +9,222 @@
  * from a file will also be available.
  */
 
+#include <inttypes.h>
 #include <stdio.h>
+#include <time.h>
 
 #include "almeielm.h"
+#include "cube.h"
+#include "epidemic.h"
+#include "filter.h"
+#include "groupby.h"
 #include "linkedlist.h"
+#include "nodepool.h"
+#include "options.h"
+#include "population.h"
+#include "replicates.h"
+#include "scan.h"
+#include "workload.h"
 
-#define HOUSEHOLD_LIMIT 100
-
-int main() {
-  int userChoice;                           // user choice for menu
-  household itemHead = generateHousehold(); // create first household item
-  Node *head = makeNode(itemHead); // add the first created household to the
-                                   // head of the linked list
-
-  // add randomized data to the linked list
-  for (int household_ctr = 1; household_ctr < HOUSEHOLD_LIMIT;
-       household_ctr++) {
-    // generate a new household with randomized data
-    household item = generateHousehold();
-    // add the new randomized data household to the linked list
-    addNode(&head, item);
+// lists of more households than this aren't printed unless asked for
+#define PRINT_LIMIT 1000
+
+/**
+ * Print the linked list, unless it is too long to be worth printing
+ *
+ * @param head
+ */
+static void printLinkedListIfSmall(Node *head) {
+  long households = getNodePoolStats().nodesInUse;
+  if (households > PRINT_LIMIT)
+    printf("\n%ld households, too many to print -- choose option 8 to print "
+           "them anyway.\n\n",
+           households);
+  else
+    printLinkedList(head);
+}
+
+/**
+ * Count the households matching a filter expression, in a households file or
+ * in a generated population, and print them unless there are too many
+ *
+ * @param options
+ * @param distribution of the population, NULL for uniform households
+ * @return 1 if the households were filtered, 0 otherwise
+ */
+static int printFilterMatches(const program_options *options,
+                              const household_distribution *distribution) {
+  household_filter filter;
+  household_columns population;
+  struct timespec start, end;
+  long matches, pruned = getBlocksPruned();
+  int ctr = 0;
+
+  if (!compileFilter(options->filter, &filter))
+    return 0;
+  initColumns(&population);
+  if (options->input == NULL &&
+      (!printPopulationMemoryEstimate(options->households, 1,
+                                      POPULATION_COLUMNS) ||
+       !generatePopulation(options->seed, options->households,
+                           options->threads, distribution, &population))) {
+    printf("Not enough memory to generate the population.\n");
+    return 0;
   }
 
-  // print linked list data
-  printLinkedList(head);
+  // count first, the matches are only worth printing when there are few
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  matches = options->input != NULL
+                ? filterHouseholdFile(options->input, &filter, NULL, NULL)
+                : countFilteredColumns(&population, &filter, options->threads);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  if (matches < 0)
+    return 0;
+  printf("%ld households match the filter (%.3f s).\n", matches,
+         (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9);
+  // a households file has no zone maps to skip blocks with
+  if (options->input == NULL)
+    printf("Blocks skipped by their zone maps: %ld of %ld\n",
+           getBlocksPruned() - pruned,
+           (population.count + COLUMNS_BLOCK_SIZE - 1) / COLUMNS_BLOCK_SIZE);
+
+  if (matches > 0 && matches <= PRINT_LIMIT) {
+    printHouseholdItemHeader();
+    if (options->input != NULL)
+      filterHouseholdFile(options->input, &filter, printMatchingHousehold,
+                          &ctr);
+    else
+      filterColumns(&population, &filter, printMatchingHousehold, &ctr);
+    printHouseholdItemSeparator();
+    printf("Number of records: %d\n", ctr);
+    puts("");
+  }
+  freeColumns(&population);
+  return 1;
+}
+
+int main(int argc, char *argv[]) {
+  int userChoice;                // user choice for menu
+  program_options options;       // command line options
+  household_columns population;  // generated population, before the list
+  household_distribution weights; // distribution of the households
+  household_distribution *distribution = NULL; // NULL for uniform households
+  Node *head = NULL;             // head of the linked list
+  household_grouping grouping;   // groups of the households, with --group-by
+
+  if (!parseProgramOptions(argc, argv, &options)) {
+    printProgramUsage(argv[0]);
+    return 1;
+  }
+
+  // counts and totals of the linked list are split over every thread
+  setScanThreads(options.threads);
+
+  // generate randomized data -- the same seed always generates the same
+  // population, whatever the number of threads
+  printf("Population seed: %" PRIu64 "\n", options.seed);
+  if (options.distribution != NULL) {
+    if (!loadDistribution(options.distribution, &weights))
+      return 1;
+    distribution = &weights;
+  }
+
+  // only the stability of the rankings over many populations is wanted
+  if (options.replicates > 0) {
+    replicate_summary summary;
+    // every thread holds the population it ranks
+    long populations = options.replicates < options.threads
+                           ? options.replicates
+                           : options.threads;
+    if (!printPopulationMemoryEstimate(options.households, populations,
+                                       POPULATION_COLUMNS) ||
+        !runReplicates(options.seed, options.replicates, options.households,
+                       options.threads, distribution, &summary)) {
+      printf("Not enough memory to generate the replicates.\n");
+      return 1;
+    }
+    printReplicateSummary(&summary);
+    return 0;
+  }
+
+  // only an epidemic over the population is wanted
+  if (options.days > 0) {
+    int simulated;
+    initColumns(&population);
+    if (!printPopulationMemoryEstimate(options.households, 1,
+                                       POPULATION_COLUMNS |
+                                           POPULATION_EPIDEMIC) ||
+        !generatePopulation(options.seed, options.households, options.threads,
+                            distribution, &population)) {
+      printf("Not enough memory to generate the population.\n");
+      return 1;
+    }
+    simulated = runEpidemic(&population, options.seed, options.days,
+                            options.threads);
+    freeColumns(&population);
+    if (!simulated) {
+      printf("Not enough memory to simulate the epidemic.\n");
+      return 1;
+    }
+    return 0;
+  }
+
+  // only the households matching an expression are wanted
+  if (options.filter != NULL)
+    return printFilterMatches(&options, distribution) ? 0 : 1;
+
+  // only a dataset on disk is wanted -- stream it without the linked list
+  if (options.output != NULL)
+    return streamPopulationToFile(options.seed, options.households,
+                                  options.threads, distribution,
+                                  options.output)
+               ? 0
+               : 1;
+
+  // a group-by is compiled before the population is generated for it
+  if (options.groupBy != NULL && !compileGrouping(options.groupBy, &grouping))
+    return 1;
+
+  if (!printPopulationMemoryEstimate(options.households, 1,
+                                     POPULATION_COLUMNS | POPULATION_LIST)) {
+    printf("Not enough memory to generate the population.\n");
+    return 1;
+  }
+  initColumns(&population);
+  if (!generatePopulation(options.seed, options.households, options.threads,
+                          distribution, &population)) {
+    printf("Not enough memory to generate the population.\n");
+    return 1;
+  }
+
+  // add the randomized data to the linked list
+  if (!addPopulationToLinkedList(&head, &population)) {
+    printf("Not enough memory to add the population to the linked list.\n");
+    freeColumns(&population);
+    freeLinkedList(&head);
+    return 1;
+  }
+  freeColumns(&population);
+
+  // only the groups of the households are wanted
+  if (options.groupBy != NULL) {
+    int grouped = groupLinkedList(head, &grouping);
+    printGroups(&grouping);
+    freeGrouping(&grouping);
+    freeLinkedList(&head);
+    return grouped ? 0 : 1;
+  }
+
+  // only the throughput and latency of a workload against the list is wanted
+  if (options.workload) {
+    runWorkload(&head, &options.mix, options.seed);
+    printNodePoolStats();
+    freeLinkedList(&head);
+    return 0;
+  }
+
+  // print linked list data, a large population would take hours
+  printLinkedListIfSmall(head);
 
   do {
     // display menu for user choice
@@ -59,7 +251,7 @@ int main() {
     case 4:
       // display households of a region with a given minimum number of people
       // tested positive for COVID-19
-      displayByRegionMinTestedPositive(head);
+      displayByRegionMinTestedPositive();
       break;
     case 5:
       // display the regions town-wise ranking of number of people tested
@@ -74,7 +266,7 @@ int main() {
     case 7:
       // delete all records of a region, town and race triplet
       head = deleteByRegionTownRace(head);
-      printLinkedList(head);
+      printLinkedListIfSmall(head);
       break;
     case 8:
       // display updated data
@@ -88,6 +280,24 @@ int main() {
       // display data fromm a file
       readDataFromFile();
       break;
+    case 11:
+      // display the totals of every race within every region
+      printRaceTotalsByRegion();
+      break;
+    case 12:
+      // display households matching a filter expression
+      displayHouseholdsByFilter(head);
+      break;
+    case 13:
+      // display the listings of a region, a race and a minimum tested positive
+      // from a single scan, followed by the rankings
+      displayReport(head);
+      break;
+    case 14:
+      // display the households of a region with the most people tested
+      // positive, or the highest share of them
+      displayTopHouseholdsByRegion();
+      break;
     default:
       printf("Please enter a valid option.\n\n");
       break;
@@ -97,4 +307,8 @@ int main() {
   // goodbye
   if (!userChoice)
     printf("\nGoodbye! Have a nice day.\n");
+
+  // release every node of the linked list at once
+  printNodePoolStats();
+  freeLinkedList(&head);
 }
@@ -0,0 +1,240 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the node slab allocator defined in
+ * nodepool.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nodepool.h"
+#include "packed.h"
+
+// states of the zone map of a block of nodes
+#define ZONE_EMPTY 0 // no household taken in since the block was carved
+#define ZONE_TIGHT 1 // the ranges are those of the nodes taken in
+#define ZONE_STALE 2 // a node has been released, the ranges may be too wide
+
+typedef struct node_slab {
+  Node nodes[NODES_PER_SLAB];
+  long sequence[NODES_PER_SLAB]; // allocation of every node, for list order
+  column_zone zones[NODE_ZONES_PER_SLAB];
+  unsigned char zoneStates[NODE_ZONES_PER_SLAB];
+} node_slab;
+
+// every slab allocated so far, the last one is being carved up
+static node_slab **slabs = NULL;
+static long slabCapacity = 0;
+static long slabCount = 0;
+static long slabUsed = NODES_PER_SLAB; // nodes handed out of the last slab
+
+// nodes given back by deletes, chained through their next pointer
+static Node *freeList = NULL;
+// allocations so far -- every allocated node is added to the head of the list
+static long nextSequence = 0;
+
+static node_pool_stats stats;
+
+/**
+ * Allocate a new slab to carve nodes out of.
+ *
+ * @return 1 if a slab has been allocated, 0 if out of memory
+ */
+static int addSlab() {
+  node_slab *slab;
+
+  // grow the table of slabs, it is only needed to release them on teardown
+  if (slabCount == slabCapacity) {
+    long capacity = slabCapacity ? slabCapacity * 2 : 16;
+    node_slab **grown = realloc(slabs, sizeof(*grown) * (size_t)capacity);
+    if (grown == NULL)
+      return 0;
+    slabs = grown;
+    slabCapacity = capacity;
+  }
+
+  slab = malloc(sizeof(*slab));
+  if (slab == NULL)
+    return 0;
+
+  memset(slab->zoneStates, ZONE_EMPTY, sizeof(slab->zoneStates));
+  slabs[slabCount++] = slab;
+  slabUsed = 0;
+  stats.slabs++;
+  stats.bytesReserved += sizeof(*slab);
+  return 1;
+}
+
+/**
+ * Allocate a node for the linked list. Nodes freed by deletes are handed out
+ * first, otherwise the next node of the current slab is used. Every node keeps
+ * the same id for as long as the pool lives, so ids stay dense, and is stamped
+ * with the number of allocations before it.
+ *
+ * @return the node, or NULL if out of memory
+ */
+Node *allocateNode() {
+  Node *node;
+
+  if (freeList != NULL) {
+    // reuse a node given back by a delete
+    node = freeList;
+    freeList = freeList->next;
+    stats.nodesReused++;
+  } else {
+    // carve the next node out of the slab, consecutive nodes are adjacent
+    if (slabUsed == NODES_PER_SLAB && !addSlab())
+      return NULL;
+    node = &slabs[slabCount - 1]->nodes[slabUsed];
+    node->id = (slabCount - 1) * NODES_PER_SLAB + slabUsed;
+    slabUsed++;
+  }
+
+  slabs[node->id / NODES_PER_SLAB]->sequence[node->id % NODES_PER_SLAB] =
+      nextSequence++;
+  stats.nodesAllocated++;
+  stats.nodesInUse++;
+  return node;
+}
+
+/**
+ * Give a node back to the pool, it will be handed out by the next allocation.
+ * The zone map of its block is rebuilt by the next scan reading it.
+ *
+ * @param node
+ */
+void releaseNode(Node *node) {
+  unsigned char *state = &slabs[node->id / NODES_PER_SLAB]
+                              ->zoneStates[node->id % NODES_PER_SLAB /
+                                           COLUMNS_BLOCK_SIZE];
+  if (*state == ZONE_TIGHT)
+    *state = ZONE_STALE;
+  node->prev = node; // marks the node free for the slab scans
+  node->next = freeList;
+  freeList = node;
+  stats.nodesReleased++;
+  stats.nodesInUse--;
+}
+
+/**
+ * Release every slab at once. All nodes handed out by the pool are invalid
+ * afterwards.
+ */
+void releaseNodePool() {
+  long i;
+  for (i = 0; i < slabCount; i++)
+    free(slabs[i]);
+  free(slabs);
+
+  slabs = NULL;
+  slabCapacity = 0;
+  slabCount = 0;
+  slabUsed = NODES_PER_SLAB;
+  freeList = NULL;
+  nextSequence = 0;
+  stats.nodesInUse = 0;
+  stats.bytesReserved = 0;
+}
+
+/**
+ * Get the number of slabs of the pool
+ *
+ * @return number of slabs
+ */
+long getNodePoolSlabs() { return slabCount; }
+
+/**
+ * Get the nodes of a slab. Every node carved out of it so far is returned,
+ * free ones included -- check them with isNodeInUse.
+ *
+ * @param slab between 0 and getNodePoolSlabs() - 1
+ * @param nodes where to store the number of nodes carved out of the slab
+ * @return first node of the slab
+ */
+Node *getNodePoolSlab(long slab, long *nodes) {
+  *nodes = slab == slabCount - 1 ? slabUsed : NODES_PER_SLAB;
+  return slabs[slab]->nodes;
+}
+
+/**
+ * Get the number of allocations before a node was allocated. The list is
+ * pushed at the head, so a node with a higher sequence comes first in the
+ * list.
+ *
+ * @param node in use
+ * @return sequence of the node
+ */
+long getNodeSequence(const Node *node) {
+  return slabs[node->id / NODES_PER_SLAB]->sequence[node->id % NODES_PER_SLAB];
+}
+
+/**
+ * Take the household of a node into the zone map of its block -- called for
+ * every node added to the linked list. The first household of an empty block
+ * starts its zone map over.
+ *
+ * @param node
+ */
+void addNodeToZone(const Node *node) {
+  node_slab *slab = slabs[node->id / NODES_PER_SLAB];
+  long zone = node->id % NODES_PER_SLAB / COLUMNS_BLOCK_SIZE;
+
+  if (slab->zoneStates[zone] == ZONE_EMPTY) {
+    startColumnZone(&slab->zones[zone], getNodeHousehold(node));
+    slab->zoneStates[zone] = ZONE_TIGHT;
+  } else {
+    widenColumnZone(&slab->zones[zone], getNodeHousehold(node));
+  }
+}
+
+/**
+ * Bring the zone map of a block of nodes of a slab up to date and get it. A
+ * zone map left too wide by released nodes is rebuilt from the nodes in use,
+ * which costs a read of the block, as much as scanning it without the zone
+ * map. Only the thread scanning the slab may read its zone maps.
+ *
+ * @param slab between 0 and getNodePoolSlabs() - 1
+ * @param zone between 0 and NODE_ZONES_PER_SLAB - 1
+ * @return the zone map, NULL if no node of the block is in use
+ */
+const column_zone *refreshNodePoolZone(long slab, long zone) {
+  node_slab *from = slabs[slab];
+  long carved = slab == slabCount - 1 ? slabUsed : NODES_PER_SLAB;
+  long first = zone * COLUMNS_BLOCK_SIZE, i;
+
+  if (from->zoneStates[zone] == ZONE_STALE) {
+    from->zoneStates[zone] = ZONE_EMPTY;
+    for (i = first; i < first + COLUMNS_BLOCK_SIZE && i < carved; i++) {
+      if (isNodeInUse(&from->nodes[i]))
+        addNodeToZone(&from->nodes[i]);
+    }
+  }
+  return from->zoneStates[zone] == ZONE_EMPTY ? NULL : &from->zones[zone];
+}
+
+/**
+ * Get the memory held by a slab of the pool
+ *
+ * @return bytes of a slab
+ */
+long getNodePoolSlabBytes() { return (long)sizeof(node_slab); }
+
+/**
+ * Get the allocation statistics of the pool
+ *
+ * @return allocation statistics
+ */
+node_pool_stats getNodePoolStats() { return stats; }
+
+/**
+ * Print the allocation statistics of the pool to the console
+ */
+void printNodePoolStats() {
+  printf("Node pool: %ld nodes allocated (%ld reused) using %ld slab "
+         "allocations, %ld nodes in use, %ld bytes reserved.\n",
+         stats.nodesAllocated, stats.nodesReused, stats.slabs,
+         stats.nodesInUse, stats.bytesReserved);
+}
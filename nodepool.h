@@ -0,0 +1,72 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the slab allocator used for the linked
+ * list nodes. Nodes are carved out of large slabs one after the other, so the
+ * list sits close together in memory, and deleted nodes are kept on a free
+ * list to be handed out again.
+ *
+ * The pool only holds the nodes of the linked list, so going through its slabs
+ * visits every household of the list -- in memory order instead of list
+ * order, and split into ranges of slabs for several threads. Every block of
+ * COLUMNS_BLOCK_SIZE nodes keeps a zone map of its households, so a scan skips
+ * the blocks that can't match.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_NODEPOOL_H
+#define ELMERALMEIDAASSIGN3_NODEPOOL_H
+
+#include "almeielm.h"
+#include "columnar.h"
+
+#define NODES_PER_SLAB 4096
+// zone maps of a slab, one per COLUMNS_BLOCK_SIZE nodes
+#define NODE_ZONES_PER_SLAB (NODES_PER_SLAB / COLUMNS_BLOCK_SIZE)
+
+typedef struct node_pool_stats {
+  long slabs;          // number of slabs allocated (one malloc each)
+  long nodesAllocated; // number of nodes handed out
+  long nodesReused;    // nodes handed out from the free list
+  long nodesReleased;  // nodes given back to the free list
+  long nodesInUse;     // nodes currently part of a list
+  long bytesReserved;  // memory held by the slabs
+} node_pool_stats;
+
+/*
+ * Node allocation
+ */
+Node *allocateNode();
+void releaseNode(Node *node);
+void releaseNodePool();
+
+/**
+ * Check whether a node of a slab is part of the list. A node given back to the
+ * pool points back to itself, which no node of the list does.
+ *
+ * @param node
+ * @return 1 if the node is in use, 0 if it is free
+ */
+static inline int isNodeInUse(const Node *node) { return node->prev != node; }
+
+/*
+ * Slab access, to scan every node of the list in memory order
+ */
+long getNodePoolSlabs();
+Node *getNodePoolSlab(long slab, long *nodes);
+long getNodeSequence(const Node *node);
+long getNodePoolSlabBytes();
+
+/*
+ * Zone maps of the blocks of nodes
+ */
+void addNodeToZone(const Node *node);
+const column_zone *refreshNodePoolZone(long slab, long zone);
+
+/*
+ * Allocation statistics
+ */
+node_pool_stats getNodePoolStats();
+void printNodePoolStats();
+
+#endif // ELMERALMEIDAASSIGN3_NODEPOOL_H
@@ -0,0 +1,219 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the command line options defined in
+ * options.h
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "options.h"
+
+/**
+ * Parse an unsigned number option value
+ *
+ * @param text value given on the command line
+ * @param value where to store the number
+ * @return 1 if the value is a valid number, 0 otherwise
+ */
+static int parseUnsigned(const char *text, uint64_t *value) {
+  char *end;
+  unsigned long long number;
+
+  // strtoull happily takes a minus sign, refuse it
+  if (text == NULL || *text == '\0' || *text == '-')
+    return 0;
+  errno = 0;
+  number = strtoull(text, &end, 10);
+  if (errno != 0 || *end != '\0')
+    return 0;
+  *value = (uint64_t)number;
+  return 1;
+}
+
+/**
+ * Parse the command line options. Options that are not given keep their
+ * default value.
+ *
+ * @param argc
+ * @param argv
+ * @param options where to store the options
+ * @return 1 if every option is valid, 0 otherwise
+ */
+int parseProgramOptions(int argc, char *argv[], program_options *options) {
+  uint64_t value;
+  long processors = sysconf(_SC_NPROCESSORS_ONLN);
+  int i;
+
+  // default to a different population on every run, using every processor
+  options->seed = (uint64_t)time(NULL);
+  options->threads = processors > 0 ? (int)processors : 1;
+  options->households = DEFAULT_HOUSEHOLDS;
+  options->output = NULL;
+  options->distribution = NULL;
+  options->replicates = 0;
+  options->days = 0;
+  options->workload = 0;
+  initWorkloadOptions(&options->mix);
+  options->filter = NULL;
+  options->input = NULL;
+  options->groupBy = NULL;
+
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--seed") == 0) {
+      // seed of the population generator, to reproduce a population
+      if (i + 1 == argc || !parseUnsigned(argv[++i], &options->seed)) {
+        printf("--seed expects a non-negative integer.\n");
+        return 0;
+      }
+    } else if (strcmp(argv[i], "--threads") == 0) {
+      // number of threads, the population is the same whatever the number
+      if (i + 1 == argc || !parseUnsigned(argv[++i], &value) || value < 1 ||
+          value > MAX_THREADS) {
+        printf("--threads expects an integer between 1 and %d.\n",
+               MAX_THREADS);
+        return 0;
+      }
+      options->threads = (int)value;
+    } else if (strcmp(argv[i], "--households") == 0) {
+      // size of the population, so scale runs don't need a recompile
+      if (i + 1 == argc || !parseUnsigned(argv[++i], &value) || value < 1 ||
+          value > MAX_HOUSEHOLDS) {
+        printf("--households expects an integer between 1 and %ld.\n",
+               MAX_HOUSEHOLDS);
+        return 0;
+      }
+      options->households = (long)value;
+    } else if (strcmp(argv[i], "--output") == 0) {
+      // write the population to a file instead of building the linked list
+      if (i + 1 == argc) {
+        printf("--output expects a file name.\n");
+        return 0;
+      }
+      options->output = argv[++i];
+    } else if (strcmp(argv[i], "--distribution") == 0) {
+      // weights of the regions, towns, races, sizes and positive cases
+      if (i + 1 == argc) {
+        printf("--distribution expects a file name.\n");
+        return 0;
+      }
+      options->distribution = argv[++i];
+    } else if (strcmp(argv[i], "--replicates") == 0) {
+      // rank many populations instead of opening the menu on a single one
+      if (i + 1 == argc || !parseUnsigned(argv[++i], &value) || value < 1 ||
+          value > MAX_REPLICATES) {
+        printf("--replicates expects an integer between 1 and %ld.\n",
+               MAX_REPLICATES);
+        return 0;
+      }
+      options->replicates = (long)value;
+    } else if (strcmp(argv[i], "--simulate") == 0) {
+      // simulate an epidemic over the population instead of the menu
+      if (i + 1 == argc || !parseUnsigned(argv[++i], &value) || value < 1 ||
+          value > MAX_SIMULATION_DAYS) {
+        printf("--simulate expects an integer between 1 and %d.\n",
+               MAX_SIMULATION_DAYS);
+        return 0;
+      }
+      options->days = (int)value;
+    } else if (strcmp(argv[i], "--workload") == 0) {
+      // replay a mix of operations against the list instead of the menu
+      if (i + 1 == argc || !parseWorkloadMix(argv[++i], &options->mix)) {
+        printf("--workload expects the weight of every operation, for example "
+               "add=60,delete=1,filter=10,count=24,rank=5\n");
+        return 0;
+      }
+      options->workload = 1;
+    } else if (strcmp(argv[i], "--operations") == 0) {
+      if (i + 1 == argc || !parseUnsigned(argv[++i], &value) || value < 1 ||
+          value > MAX_HOUSEHOLDS) {
+        printf("--operations expects an integer between 1 and %ld.\n",
+               MAX_HOUSEHOLDS);
+        return 0;
+      }
+      options->mix.operations = (long)value;
+    } else if (strcmp(argv[i], "--rate") == 0) {
+      // operations started per second, 0 to run them back to back
+      if (i + 1 == argc || !parseUnsigned(argv[++i], &value) ||
+          value > 1000000000) {
+        printf("--rate expects an integer between 0 and 1000000000.\n");
+        return 0;
+      }
+      options->mix.rate = (double)value;
+    } else if (strcmp(argv[i], "--filter") == 0) {
+      // print the households matching an expression instead of the menu
+      if (i + 1 == argc) {
+        printf("--filter expects an expression, for example \"region=1 AND "
+               "race IN (0,3) AND tested>=5\"\n");
+        return 0;
+      }
+      options->filter = argv[++i];
+    } else if (strcmp(argv[i], "--input") == 0) {
+      // filter a households file instead of a generated population
+      if (i + 1 == argc) {
+        printf("--input expects a file name.\n");
+        return 0;
+      }
+      options->input = argv[++i];
+    } else if (strcmp(argv[i], "--group-by") == 0) {
+      // print the groups of the households instead of the menu
+      if (i + 1 == argc) {
+        printf("--group-by expects key fields and measures, for example "
+               "\"region,race: count, avg(tested)\"\n");
+        return 0;
+      }
+      options->groupBy = argv[++i];
+    } else {
+      printf("Unknown option: %s\n", argv[i]);
+      return 0;
+    }
+  }
+  if (options->input != NULL && options->filter == NULL) {
+    printf("--input is only read with --filter.\n");
+    return 0;
+  }
+  return 1;
+}
+
+/**
+ * Print the command line options of the program
+ *
+ * @param program name the program was run with
+ */
+void printProgramUsage(char *program) {
+  printf("Usage: %s [options]\n", program);
+  printf("  --seed N             seed of the population generator, the same "
+         "seed generates the same population\n");
+  printf("  --threads N          number of threads to generate the population "
+         "with (default: number of processors)\n");
+  printf("  --households N       number of households to generate (default: "
+         "%d)\n",
+         DEFAULT_HOUSEHOLDS);
+  printf("  --output FILE        write the population to a file and exit, "
+         "without building the linked list\n");
+  printf("  --distribution FILE  generate the households from the weights of "
+         "a distribution file (default: uniform)\n");
+  printf("  --replicates R       rank R populations of the given size and "
+         "summarize the rankings, then exit\n");
+  printf("  --simulate DAYS      simulate an epidemic over the population for "
+         "DAYS days, then exit\n");
+  printf("  --workload MIX       replay a mix of operations against the list, "
+         "then exit (add=60,delete=1,filter=10,count=24,rank=5)\n");
+  printf("  --operations N       number of operations of the workload "
+         "(default: %ld)\n",
+         DEFAULT_WORKLOAD_OPERATIONS);
+  printf("  --rate N             operations of the workload arriving every "
+         "second (default: 0, back to back)\n");
+  printf("  --filter EXPR        print the households matching an expression, "
+         "then exit (\"region=1 AND tested>=5\")\n");
+  printf("  --input FILE         filter a households file instead of "
+         "generating a population\n");
+  printf("  --group-by SPEC      print the groups of the households, then exit "
+         "(\"region,race: count, avg(tested)\")\n");
+}
@@ -0,0 +1,40 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the command line options of the
+ * program.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_OPTIONS_H
+#define ELMERALMEIDAASSIGN3_OPTIONS_H
+
+#include <stdint.h>
+
+#include "epidemic.h"
+#include "replicates.h"
+#include "workload.h"
+
+#define MAX_THREADS 1024
+#define DEFAULT_HOUSEHOLDS 100
+#define MAX_HOUSEHOLDS 2000000000L
+
+typedef struct program_options {
+  uint64_t seed;        // seed of the population generator
+  int threads;          // number of threads to generate the population with
+  long households;      // number of households to generate
+  char *output;         // file to stream the population to, NULL for the menu
+  char *distribution;   // distribution file of the households, NULL for uniform
+  long replicates;      // populations to generate and rank, 0 for the menu
+  int days;             // days of epidemic to simulate, 0 for the menu
+  int workload;         // 1 to replay the workload instead of the menu
+  workload_options mix; // operations of the workload
+  char *filter;         // filter expression to print the matches of
+  char *input;          // households file to filter, NULL for the population
+  char *groupBy;        // group-by to print the groups of, NULL for the menu
+} program_options;
+
+int parseProgramOptions(int argc, char *argv[], program_options *options);
+void printProgramUsage(char *program);
+
+#endif // ELMERALMEIDAASSIGN3_OPTIONS_H
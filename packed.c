@@ -0,0 +1,52 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the bit-packed household record
+ * defined in packed.h
+ */
+
+#include "packed.h"
+
+/**
+ * Check that a value fits in a field of the specified width.
+ *
+ * @param value
+ * @param bits
+ * @return 1 if the value fits, 0 otherwise
+ */
+static int fitsField(int value, int bits) {
+  return value >= 0 && value < (1 << bits);
+}
+
+/**
+ * Pack a household into a single 64-bit word.
+ *
+ * @param item household to pack
+ * @param packed where to store the packed household
+ * @return 1 if the household has been packed, 0 if a field is out of range
+ */
+int encodeHousehold(household item, packed_household *packed) {
+  // region 0 - 2, town 0 - 1, race 0 - 4 and the measures up to 2047
+  if (!fitsField(item.region, PACKED_REGION_BITS) ||
+      !fitsField(item.town, PACKED_TOWN_BITS) ||
+      !fitsField(item.race, PACKED_RACE_BITS) ||
+      !fitsField(item.size, PACKED_MEASURE_BITS) ||
+      !fitsField(item.seniors, PACKED_MEASURE_BITS) ||
+      !fitsField(item.adultsWithChronicDiseases, PACKED_MEASURE_BITS) ||
+      !fitsField(item.tested, PACKED_MEASURE_BITS) ||
+      !fitsField(item.adultsTestedPositive, PACKED_MEASURE_BITS))
+    return 0;
+
+  *packed = (packed_household)item.region << PACKED_REGION_SHIFT |
+            (packed_household)item.town << PACKED_TOWN_SHIFT |
+            (packed_household)item.race << PACKED_RACE_SHIFT |
+            (packed_household)item.size << PACKED_SIZE_SHIFT |
+            (packed_household)item.seniors << PACKED_SENIORS_SHIFT |
+            (packed_household)item.adultsWithChronicDiseases
+                << PACKED_CHRONIC_SHIFT |
+            (packed_household)item.tested << PACKED_TESTED_SHIFT |
+            (packed_household)item.adultsTestedPositive
+                << PACKED_POSITIVE_SHIFT;
+  return 1;
+}
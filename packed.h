@@ -0,0 +1,79 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the bit-packed household record. A
+ * packed household holds every field of the household structure in a single
+ * 64-bit word, a quarter of the memory of the household structure. Every node
+ * of the linked list holds its household packed.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_PACKED_H
+#define ELMERALMEIDAASSIGN3_PACKED_H
+
+#include <stdint.h>
+
+#include "almeielm.h"
+
+/*
+ * Bit layout of a packed household, from the lowest bit:
+ * region (2) town (1) race (3) size, seniors, adultsWithChronicDiseases,
+ * tested and adultsTestedPositive (11 each)
+ */
+#define PACKED_REGION_BITS 2
+#define PACKED_TOWN_BITS 1
+#define PACKED_RACE_BITS 3
+#define PACKED_MEASURE_BITS 11
+
+#define PACKED_REGION_SHIFT 0
+#define PACKED_TOWN_SHIFT (PACKED_REGION_SHIFT + PACKED_REGION_BITS)
+#define PACKED_RACE_SHIFT (PACKED_TOWN_SHIFT + PACKED_TOWN_BITS)
+#define PACKED_SIZE_SHIFT (PACKED_RACE_SHIFT + PACKED_RACE_BITS)
+#define PACKED_SENIORS_SHIFT (PACKED_SIZE_SHIFT + PACKED_MEASURE_BITS)
+#define PACKED_CHRONIC_SHIFT (PACKED_SENIORS_SHIFT + PACKED_MEASURE_BITS)
+#define PACKED_TESTED_SHIFT (PACKED_CHRONIC_SHIFT + PACKED_MEASURE_BITS)
+#define PACKED_POSITIVE_SHIFT (PACKED_TESTED_SHIFT + PACKED_MEASURE_BITS)
+
+// largest household measure (size, seniors, ...) that can be packed
+#define PACKED_MEASURE_MAX ((1 << PACKED_MEASURE_BITS) - 1)
+
+// extract a field of a packed household
+#define PACKED_FIELD(packed, shift, bits)                                      \
+  ((int)(((packed) >> (shift)) & ((UINT64_C(1) << (bits)) - 1)))
+
+int encodeHousehold(household item, packed_household *packed);
+
+/**
+ * Unpack a household from its 64-bit word. Defined here so the scans of the
+ * linked list can inline it.
+ *
+ * @param packed
+ * @return the household item
+ */
+static inline household decodeHousehold(packed_household packed) {
+  household item;
+  item.region = PACKED_FIELD(packed, PACKED_REGION_SHIFT, PACKED_REGION_BITS);
+  item.town = PACKED_FIELD(packed, PACKED_TOWN_SHIFT, PACKED_TOWN_BITS);
+  item.race = PACKED_FIELD(packed, PACKED_RACE_SHIFT, PACKED_RACE_BITS);
+  item.size = PACKED_FIELD(packed, PACKED_SIZE_SHIFT, PACKED_MEASURE_BITS);
+  item.seniors =
+      PACKED_FIELD(packed, PACKED_SENIORS_SHIFT, PACKED_MEASURE_BITS);
+  item.adultsWithChronicDiseases =
+      PACKED_FIELD(packed, PACKED_CHRONIC_SHIFT, PACKED_MEASURE_BITS);
+  item.tested = PACKED_FIELD(packed, PACKED_TESTED_SHIFT, PACKED_MEASURE_BITS);
+  item.adultsTestedPositive =
+      PACKED_FIELD(packed, PACKED_POSITIVE_SHIFT, PACKED_MEASURE_BITS);
+  return item;
+}
+
+/**
+ * Get the household of a linked list node
+ *
+ * @param node
+ * @return the unpacked household
+ */
+static inline household getNodeHousehold(const Node *node) {
+  return decodeHousehold(node->packed);
+}
+
+#endif // ELMERALMEIDAASSIGN3_PACKED_H
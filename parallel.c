@@ -0,0 +1,123 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the parallel range runner defined
+ * in parallel.h
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "parallel.h"
+
+// partial results are kept a cache line apart, threads never share one
+#define RANGE_CACHE_LINE 64
+
+typedef struct range_worker {
+  pthread_t thread;
+  range_work work;
+  const void *context;
+  void *partial;
+  long first;
+  long last;
+  int started; // 1 if the worker runs on its own thread
+} range_worker;
+
+/**
+ * Get the number of threads a scan is split over -- every thread gets at
+ * least a grain of items, so a small scan isn't worth a thread
+ *
+ * @param items
+ * @param grain smallest number of items worth a thread
+ * @param threads most threads to use
+ * @return number of threads
+ */
+int getRangeThreads(long items, long grain, int threads) {
+  long grains = grain > 0 ? (items + grain - 1) / grain : items;
+  if (threads > grains)
+    threads = (int)grains;
+  return threads > 1 ? threads : 1;
+}
+
+/**
+ * Thread entry point -- gather the range of the worker
+ *
+ * @param argument the range worker
+ * @return NULL
+ */
+static void *runRangeWorker(void *argument) {
+  range_worker *worker = argument;
+  worker->work(worker->first, worker->last, worker->context, worker->partial);
+  return NULL;
+}
+
+/**
+ * Gather items from several threads, each over a contiguous range of whole
+ * grains into a zeroed partial result of its own, then merge the partial
+ * results into the result in thread order. A thread that can't be started has
+ * its range gathered by the calling thread.
+ *
+ * @param items number of items to gather
+ * @param grain items a range is a multiple of, and the least worth a thread
+ * @param threads most threads to use
+ * @param work gathers a range into a partial result
+ * @param merge merges a partial result into the result
+ * @param context passed on to every range
+ * @param result to merge into
+ * @param partialSize size of a partial result
+ * @return 1 if the items have been gathered, 0 if out of memory
+ */
+int runParallelRanges(long items, long grain, int threads, range_work work,
+                      range_merge merge, const void *context, void *result,
+                      size_t partialSize) {
+  size_t stride = (partialSize + RANGE_CACHE_LINE - 1) / RANGE_CACHE_LINE *
+                  RANGE_CACHE_LINE;
+  range_worker *workers;
+  unsigned char *partials;
+  long grains, first = 0;
+  int i;
+
+  if (grain < 1)
+    grain = 1;
+  threads = getRangeThreads(items, grain, threads);
+  workers = malloc(sizeof(*workers) * (size_t)threads);
+  partials = calloc((size_t)threads, stride);
+  if (workers == NULL || partials == NULL) {
+    free(workers);
+    free(partials);
+    return 0;
+  }
+
+  // share the grains out evenly, the first ranges take the leftovers
+  grains = (items + grain - 1) / grain;
+  for (i = 0; i < threads; i++) {
+    long share = grains / threads + (i < grains % threads);
+    workers[i].work = work;
+    workers[i].context = context;
+    workers[i].partial = partials + (size_t)i * stride;
+    workers[i].first = first;
+    workers[i].last = first + share * grain < items ? first + share * grain
+                                                    : items;
+    first = workers[i].last;
+  }
+
+  // the calling thread takes the first range, others get a thread each
+  for (i = 1; i < threads; i++)
+    workers[i].started = pthread_create(&workers[i].thread, NULL,
+                                        runRangeWorker, &workers[i]) == 0;
+  runRangeWorker(&workers[0]);
+  for (i = 1; i < threads; i++) {
+    if (workers[i].started)
+      pthread_join(workers[i].thread, NULL);
+    else
+      runRangeWorker(&workers[i]);
+  }
+
+  for (i = 0; i < threads; i++)
+    merge(workers[i].partial, result);
+  free(workers);
+  free(partials);
+  return 1;
+}
@@ -0,0 +1,28 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the parallel range runner. The items of
+ * a scan are split into one contiguous range per thread; every thread gathers
+ * its range into a partial result of its own, and the partial results are
+ * merged in thread order once every thread is done, so no thread ever writes
+ * to shared memory.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_PARALLEL_H
+#define ELMERALMEIDAASSIGN3_PARALLEL_H
+
+#include <stddef.h>
+
+// gather the items first to last - 1 into the partial result of the thread
+typedef void (*range_work)(long first, long last, const void *context,
+                           void *partial);
+// merge the partial result of a thread into the result
+typedef void (*range_merge)(const void *partial, void *result);
+
+int getRangeThreads(long items, long grain, int threads);
+int runParallelRanges(long items, long grain, int threads, range_work work,
+                      range_merge merge, const void *context, void *result,
+                      size_t partialSize);
+
+#endif // ELMERALMEIDAASSIGN3_PARALLEL_H
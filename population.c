@@ -0,0 +1,623 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the parallel population generator
+ * defined in population.h
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "linkedlist.h"
+#include "nodepool.h"
+#include "population.h"
+#include "roaring.h"
+
+// households generated by a single generateHouseholdsBatch call
+#define POPULATION_BATCH_SIZE 1024
+// reports of progress while generating or adding a large population
+#define POPULATION_PROGRESS_STEPS 10
+
+typedef struct population_worker {
+  pthread_t thread;
+  household_columns *columns;
+  const random_context *streams; // random stream of every block
+  const household_distribution *distribution; // NULL for uniform households
+  long households;               // size of the whole population
+  long firstBlock;               // first block generated by the worker
+  long blockStep;                // number of workers, blocks are interleaved
+  int started;                   // 1 if the worker runs on its own thread
+  population_progress *progress; // NULL for a small population
+} population_worker;
+
+typedef struct population_stream {
+  pthread_mutex_t lock;
+  pthread_cond_t filled;  // signalled when a block has been generated
+  pthread_cond_t emptied; // signalled when a block has been written
+  household *slots;       // blocks being generated or written, in a ring
+  int *ready;             // 1 once the block of a slot has been generated
+  int numSlots;
+  const household_distribution *distribution; // NULL for uniform households
+  random_context next; // random stream of the next block to generate
+  long nextBlock;      // next block to hand to a generator
+  long written;        // number of blocks written to the file
+  long blocks;         // number of blocks of the whole population
+  long households;     // size of the whole population
+} population_stream;
+
+typedef struct stream_worker {
+  pthread_t thread;
+  population_stream *stream;
+  int started; // 1 if the generator runs on its own thread
+} stream_worker;
+
+/**
+ * Estimate the memory needed by a population, from generating it to holding
+ * it in the linked list and its indexes, or simulating an epidemic over it
+ *
+ * @param households size of the population
+ * @return bytes needed by every part of the population
+ */
+population_memory estimatePopulationMemory(long households) {
+  population_memory memory;
+  long blocks = (households + COLUMNS_BLOCK_SIZE - 1) / COLUMNS_BLOCK_SIZE;
+  long slabs = (households + NODES_PER_SLAB - 1) / NODES_PER_SLAB;
+  long chunks = (households + 65535) / 65536; // ids sharing a bitmap container
+  long idsPerChunk = households < 65536 ? households : 65536;
+  int categories[3] = {NUM_REGIONS, NUM_TOWNS, RACE_RANGE + 1};
+  int i;
+
+  memory.columns = households * (3 * (long)sizeof(unsigned char) +
+                                 5 * (long)sizeof(int)) +
+                   blocks * (long)sizeof(column_zone);
+  memory.nodes = slabs * getNodePoolSlabBytes();
+
+  // every household is in one region, town and race bitmap -- a container
+  // holds 2 bytes per id until it turns into a fixed size bitmap
+  memory.indexes = 0;
+  for (i = 0; i < 3; i++) {
+    long container = 2 * idsPerChunk / categories[i];
+    if (container > ROARING_BITMAP_WORDS * (long)sizeof(uint64_t))
+      container = ROARING_BITMAP_WORDS * (long)sizeof(uint64_t);
+    memory.indexes += chunks * categories[i] * container;
+  }
+
+  // a byte per household for each of the epidemic states and the town
+  memory.epidemic = 4 * households;
+  return memory;
+}
+
+/**
+ * Print the memory the populations of a run are expected to need, and check it
+ * against the physical memory of the machine. Only the parts of a population
+ * the run holds are counted, for every population held at the same time.
+ *
+ * @param households size of a population
+ * @param populations number of populations held at the same time
+ * @param parts POPULATION_ parts held, ORed together
+ * @return 1 if the populations fit in memory, 0 otherwise
+ */
+int printPopulationMemoryEstimate(long households, long populations,
+                                  unsigned parts) {
+  population_memory memory = estimatePopulationMemory(households);
+  double megabyte = 1024.0 * 1024.0;
+  long peak = 0;
+  long pages = sysconf(_SC_PHYS_PAGES), pageSize = sysconf(_SC_PAGE_SIZE);
+  const char *separator = "";
+
+  if (parts & POPULATION_COLUMNS)
+    peak += memory.columns;
+  if (parts & POPULATION_LIST)
+    peak += memory.nodes + memory.indexes;
+  if (parts & POPULATION_EPIDEMIC)
+    peak += memory.epidemic;
+  peak *= populations;
+
+  if (populations > 1)
+    printf("Estimated memory for %ld populations of %ld households: %.1f MB "
+           "(",
+           populations, households, peak / megabyte);
+  else
+    printf("Estimated memory for %ld households: %.1f MB (", households,
+           peak / megabyte);
+  if (parts & POPULATION_COLUMNS) {
+    printf("columns %.1f MB", populations * memory.columns / megabyte);
+    separator = ", ";
+  }
+  if (parts & POPULATION_LIST) {
+    printf("%snodes %.1f MB, indexes %.1f MB", separator,
+           populations * memory.nodes / megabyte,
+           populations * memory.indexes / megabyte);
+    separator = ", ";
+  }
+  if (parts & POPULATION_EPIDEMIC)
+    printf("%sepidemic %.1f MB", separator,
+           populations * memory.epidemic / megabyte);
+  printf(")\n");
+
+  // an unknown amount of memory is taken as enough
+  if (pages > 0 && pageSize > 0 && peak / pageSize > pages) {
+    printf("Only %.1f MB of memory available.\n",
+           (double)pages * pageSize / megabyte);
+    return 0;
+  }
+  return 1;
+}
+
+/**
+ * Get the number of seconds elapsed since a point in time
+ *
+ * @param start
+ * @return seconds elapsed
+ */
+static double secondsSince(const struct timespec *start) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)(now.tv_sec - start->tv_sec) +
+         (double)(now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**
+ * Start reporting the progress of a large population, nothing is reported for
+ * a small one
+ *
+ * @param progress
+ * @param action what is being done to the households, for the reports
+ * @param households size of the population
+ * @return the progress to report to, NULL for a small population
+ */
+population_progress *startPopulationProgress(population_progress *progress,
+                                             const char *action,
+                                             long households) {
+  if (households < POPULATION_PROGRESS_MIN)
+    return NULL;
+  pthread_mutex_init(&progress->lock, NULL);
+  clock_gettime(CLOCK_MONOTONIC, &progress->start);
+  progress->action = action;
+  progress->households = households;
+  progress->done = 0;
+  progress->nextReport = households / POPULATION_PROGRESS_STEPS;
+  return progress;
+}
+
+/**
+ * Add households to the progress, and print it every tenth of the population
+ *
+ * @param progress NULL for a small population
+ * @param households number of households just done
+ */
+void reportPopulationProgress(population_progress *progress, long households) {
+  double seconds;
+  if (progress == NULL)
+    return;
+
+  pthread_mutex_lock(&progress->lock);
+  progress->done += households;
+  if (progress->done >= progress->nextReport &&
+      progress->done < progress->households) {
+    seconds = secondsSince(&progress->start);
+    printf("%s %ld of %ld households (%.0f%%, %.0f households/s)\n",
+           progress->action, progress->done, progress->households,
+           100.0 * progress->done / progress->households,
+           seconds > 0 ? progress->done / seconds : 0.0);
+    fflush(stdout);
+    while (progress->nextReport <= progress->done)
+      progress->nextReport += progress->households / POPULATION_PROGRESS_STEPS;
+  }
+  pthread_mutex_unlock(&progress->lock);
+}
+
+/**
+ * Print the time taken and the throughput of a large population
+ *
+ * @param progress NULL for a small population
+ */
+void finishPopulationProgress(population_progress *progress) {
+  double seconds;
+  if (progress == NULL)
+    return;
+
+  seconds = secondsSince(&progress->start);
+  printf("%s %ld households in %.2f s (%.0f households/s)\n", progress->action,
+         progress->households, seconds,
+         seconds > 0 ? progress->households / seconds : 0.0);
+  pthread_mutex_destroy(&progress->lock);
+}
+
+/**
+ * Get the number of households in a block, only the last block can be short
+ *
+ * @param block
+ * @param households size of the whole population
+ * @return number of households in the block
+ */
+static long blockHouseholds(long block, long households) {
+  long rows = households - block * POPULATION_BLOCK_SIZE;
+  return rows < POPULATION_BLOCK_SIZE ? rows : POPULATION_BLOCK_SIZE;
+}
+
+/**
+ * Generate a batch of households, from a distribution or uniform ranges
+ *
+ * @param distribution NULL for uniform households
+ * @param rng
+ * @param count number of households to generate
+ * @param out where to write the households
+ */
+static void generateBatch(const household_distribution *distribution,
+                          random_context *rng, long count, household *out) {
+  if (distribution == NULL)
+    generateHouseholdsBatch(rng, count, out);
+  else
+    sampleHouseholdsBatch(distribution, rng, count, out);
+}
+
+/**
+ * Generate a single block of the population from its own random stream
+ *
+ * @param columns
+ * @param distribution distribution of the households, NULL for uniform
+ * @param stream random stream of the block
+ * @param block
+ * @param households size of the whole population
+ */
+static void generateBlock(household_columns *columns,
+                          const household_distribution *distribution,
+                          random_context stream, long block, long households) {
+  household batch[POPULATION_BATCH_SIZE];
+  long row = block * POPULATION_BLOCK_SIZE;
+  long end = row + POPULATION_BLOCK_SIZE;
+  if (end > households)
+    end = households;
+
+  // generate a batch at a time and move it into the columns
+  while (row < end) {
+    long count = end - row < POPULATION_BATCH_SIZE ? end - row
+                                                   : POPULATION_BATCH_SIZE;
+    long i;
+    generateBatch(distribution, &stream, count, batch);
+    for (i = 0; i < count; i++)
+      setColumnsItem(columns, row + i, batch[i]);
+    row += count;
+  }
+}
+
+/**
+ * Thread entry point -- generate every block handed to the worker
+ *
+ * @param argument the population worker
+ * @return NULL
+ */
+static void *runPopulationWorker(void *argument) {
+  population_worker *worker = argument;
+  long blocks = (worker->households + POPULATION_BLOCK_SIZE - 1) /
+                POPULATION_BLOCK_SIZE;
+  long block;
+  for (block = worker->firstBlock; block < blocks; block += worker->blockStep) {
+    generateBlock(worker->columns, worker->distribution,
+                  worker->streams[block], block, worker->households);
+    reportPopulationProgress(worker->progress,
+                             blockHouseholds(block, worker->households));
+  }
+  return NULL;
+}
+
+/**
+ * Generate a population into an empty columnar store, from several threads.
+ * Block n is generated from the seeded stream jumped ahead n times, so the
+ * population only depends on the seed and not on the number of threads. A
+ * large population reports its progress and throughput as it is generated.
+ *
+ * @param seed seed of the population
+ * @param households size of the population
+ * @param threads number of threads to generate with
+ * @param distribution distribution of the households, NULL for uniform
+ * @param columns empty columnar store to fill
+ * @return 1 if the population has been generated, 0 if out of memory
+ */
+int generatePopulation(uint64_t seed, long households, int threads,
+                       const household_distribution *distribution,
+                       household_columns *columns) {
+  long blocks = (households + POPULATION_BLOCK_SIZE - 1) /
+                POPULATION_BLOCK_SIZE;
+  random_context *streams;
+  population_worker *workers;
+  population_progress progress, *reporting;
+  random_context stream;
+  long block;
+  int i;
+
+  if (households <= 0)
+    return 1;
+  if (!reserveColumns(columns, households))
+    return 0;
+
+  // hand every block its own stream, 2^128 numbers apart from the previous one
+  streams = malloc(sizeof(*streams) * (size_t)blocks);
+  if (streams == NULL)
+    return 0;
+  seedRandom(&stream, seed);
+  for (block = 0; block < blocks; block++) {
+    streams[block] = stream;
+    jumpRandom(&stream);
+  }
+
+  // no point in having more threads than blocks
+  if (threads < 1)
+    threads = 1;
+  if (threads > blocks)
+    threads = (int)blocks;
+  workers = malloc(sizeof(*workers) * (size_t)threads);
+  if (workers == NULL) {
+    free(streams);
+    return 0;
+  }
+
+  reporting = startPopulationProgress(&progress, "Generated", households);
+  for (i = 0; i < threads; i++) {
+    workers[i].progress = reporting;
+    workers[i].columns = columns;
+    workers[i].streams = streams;
+    workers[i].distribution = distribution;
+    workers[i].households = households;
+    workers[i].firstBlock = i;
+    workers[i].blockStep = threads;
+  }
+
+  // the calling thread takes the first share, others get a thread each
+  for (i = 1; i < threads; i++)
+    workers[i].started = pthread_create(&workers[i].thread, NULL,
+                                        runPopulationWorker, &workers[i]) == 0;
+  runPopulationWorker(&workers[0]);
+  for (i = 1; i < threads; i++) {
+    if (workers[i].started)
+      pthread_join(workers[i].thread, NULL);
+    else
+      runPopulationWorker(&workers[i]); // no thread for it, generate it here
+  }
+
+  finishPopulationProgress(reporting);
+  columns->count = households;
+  free(workers);
+  free(streams);
+  return 1;
+}
+
+/**
+ * Generate a population into a columnar store on the calling thread, without
+ * reporting progress. The households are the same as generatePopulation's for
+ * the same seed, and a store holding an earlier population is overwritten.
+ *
+ * @param seed seed of the population
+ * @param households size of the population
+ * @param distribution distribution of the households, NULL for uniform
+ * @param columns columnar store with room for the population
+ */
+void generatePopulationSerial(uint64_t seed, long households,
+                              const household_distribution *distribution,
+                              household_columns *columns) {
+  long blocks = (households + POPULATION_BLOCK_SIZE - 1) /
+                POPULATION_BLOCK_SIZE;
+  random_context stream;
+  long block;
+
+  seedRandom(&stream, seed);
+  for (block = 0; block < blocks; block++) {
+    generateBlock(columns, distribution, stream, block, households);
+    jumpRandom(&stream);
+  }
+  columns->count = households;
+}
+
+/**
+ * Add every household of a generated population to the linked list, in
+ * order. The last household ends up at the head of the list, as if each one
+ * had been added with addNode as it was generated. A large population reports
+ * its progress as it is added.
+ *
+ * @param head
+ * @param columns
+ * @return 1 if every household has been added, 0 if out of memory -- the
+ * households added so far stay in the list
+ */
+int addPopulationToLinkedList(NodePtr *head,
+                              const household_columns *columns) {
+  population_progress progress, *reporting;
+  long row;
+
+  reporting = startPopulationProgress(&progress, "Added", columns->count);
+  for (row = 0; row < columns->count; row++) {
+    int added;
+    if (*head == NULL)
+      added = (*head = makeNode(getColumnsItem(columns, row))) != NULL;
+    else
+      added = addNode(head, getColumnsItem(columns, row));
+    if (!added) {
+      if (reporting != NULL)
+        pthread_mutex_destroy(&reporting->lock);
+      return 0;
+    }
+    if ((row + 1) % POPULATION_BLOCK_SIZE == 0 || row + 1 == columns->count)
+      reportPopulationProgress(reporting, row % POPULATION_BLOCK_SIZE + 1);
+  }
+  finishPopulationProgress(reporting);
+  return 1;
+}
+
+/**
+ * Generate the next block of a streamed population into its slot of the ring,
+ * once the block that was in the slot has been written
+ *
+ * @param stream
+ * @return 1 if a block has been generated, 0 if every block has been handed out
+ */
+static int fillStreamBlock(population_stream *stream) {
+  random_context blockStream;
+  household *slot;
+  long block, row, count;
+
+  // take the next block and its random stream, jumped like generatePopulation
+  pthread_mutex_lock(&stream->lock);
+  block = stream->nextBlock;
+  if (block == stream->blocks) {
+    pthread_mutex_unlock(&stream->lock);
+    return 0;
+  }
+  stream->nextBlock++;
+  blockStream = stream->next;
+  jumpRandom(&stream->next);
+  while (block >= stream->written + stream->numSlots)
+    pthread_cond_wait(&stream->emptied, &stream->lock);
+  pthread_mutex_unlock(&stream->lock);
+
+  // generate the block in batches, like generateBlock
+  slot = stream->slots + (block % stream->numSlots) * POPULATION_BLOCK_SIZE;
+  count = blockHouseholds(block, stream->households);
+  for (row = 0; row < count; row += POPULATION_BATCH_SIZE)
+    generateBatch(stream->distribution, &blockStream,
+                  count - row < POPULATION_BATCH_SIZE ? count - row
+                                                      : POPULATION_BATCH_SIZE,
+                  slot + row);
+
+  pthread_mutex_lock(&stream->lock);
+  stream->ready[block % stream->numSlots] = 1;
+  pthread_cond_broadcast(&stream->filled);
+  pthread_mutex_unlock(&stream->lock);
+  return 1;
+}
+
+/**
+ * Thread entry point -- generate blocks until every block has been handed out
+ *
+ * @param argument the stream worker
+ * @return NULL
+ */
+static void *runStreamWorker(void *argument) {
+  stream_worker *worker = argument;
+  while (fillStreamBlock(worker->stream))
+    ;
+  return NULL;
+}
+
+/**
+ * Generate a population straight into a households file, in the format of
+ * storeDataToFile, without building the linked list. Generator threads fill a
+ * ring of blocks while the calling thread writes the blocks in order, so the
+ * memory used doesn't depend on the size of the population. The file holds the
+ * same households as generatePopulation for the same seed.
+ *
+ * @param seed seed of the population
+ * @param households size of the population
+ * @param threads number of threads to generate with
+ * @param distribution distribution of the households, NULL for uniform
+ * @param fileName file to write the households to
+ * @return 1 if the whole population has been written, 0 otherwise
+ */
+int streamPopulationToFile(uint64_t seed, long households, int threads,
+                           const household_distribution *distribution,
+                           const char *fileName) {
+  population_stream stream;
+  population_progress progress, *reporting;
+  stream_worker *workers;
+  FILE *file;
+  long block, row, ctr = 0;
+  int i, generators = 0, written;
+
+  if (threads < 1)
+    threads = 1;
+  stream.blocks = (households + POPULATION_BLOCK_SIZE - 1) /
+                  POPULATION_BLOCK_SIZE;
+  if (threads > stream.blocks)
+    threads = stream.blocks > 0 ? (int)stream.blocks : 1;
+
+  // a slot for the block every generator works on, and one being written
+  stream.numSlots = threads + 1;
+  stream.slots = malloc(sizeof(household) * POPULATION_BLOCK_SIZE *
+                        (size_t)stream.numSlots);
+  stream.ready = calloc((size_t)stream.numSlots, sizeof(int));
+  workers = malloc(sizeof(*workers) * (size_t)threads);
+  if (stream.slots == NULL || stream.ready == NULL || workers == NULL) {
+    printf("Not enough memory to generate the population.\n");
+    free(stream.slots);
+    free(stream.ready);
+    free(workers);
+    return 0;
+  }
+
+  file = fopen(fileName, "w");
+  if (file == NULL) {
+    printf("Unable to create/write to file.\n");
+    free(stream.slots);
+    free(stream.ready);
+    free(workers);
+    return 0;
+  }
+
+  pthread_mutex_init(&stream.lock, NULL);
+  pthread_cond_init(&stream.filled, NULL);
+  pthread_cond_init(&stream.emptied, NULL);
+  seedRandom(&stream.next, seed);
+  stream.nextBlock = 0;
+  stream.written = 0;
+  stream.households = households;
+  stream.distribution = distribution;
+
+  for (i = 0; i < threads; i++) {
+    workers[i].stream = &stream;
+    workers[i].started = pthread_create(&workers[i].thread, NULL,
+                                        runStreamWorker, &workers[i]) == 0;
+    generators += workers[i].started;
+  }
+
+  // write the blocks in order as they are generated
+  reporting = startPopulationProgress(&progress, "Wrote", households);
+  writeHouseholdHeader(file);
+  for (block = 0; block < stream.blocks; block++) {
+    int slot = (int)(block % stream.numSlots);
+    long count = blockHouseholds(block, households);
+    household *items = stream.slots + (long)slot * POPULATION_BLOCK_SIZE;
+
+    if (generators == 0)
+      fillStreamBlock(&stream); // no thread to generate it, do it here
+    pthread_mutex_lock(&stream.lock);
+    while (!stream.ready[slot])
+      pthread_cond_wait(&stream.filled, &stream.lock);
+    pthread_mutex_unlock(&stream.lock);
+
+    for (row = 0; row < count; row++)
+      writeHouseholdRecord(file, ++ctr, items[row]);
+    reportPopulationProgress(reporting, count);
+
+    // hand the slot back to the generators
+    pthread_mutex_lock(&stream.lock);
+    stream.ready[slot] = 0;
+    stream.written++;
+    pthread_cond_broadcast(&stream.emptied);
+    pthread_mutex_unlock(&stream.lock);
+  }
+  finishPopulationProgress(reporting);
+
+  for (i = 0; i < threads; i++) {
+    if (workers[i].started)
+      pthread_join(workers[i].thread, NULL);
+  }
+  written = !ferror(file);
+  if (fclose(file) != 0)
+    written = 0;
+  if (written)
+    printf("%ld records have been written to the file: %s\n", ctr, fileName);
+  else
+    printf("Unable to create/write to file.\n");
+
+  pthread_cond_destroy(&stream.emptied);
+  pthread_cond_destroy(&stream.filled);
+  pthread_mutex_destroy(&stream.lock);
+  free(workers);
+  free(stream.ready);
+  free(stream.slots);
+  return written;
+}
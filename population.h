@@ -0,0 +1,73 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the parallel population generator. The
+ * population is cut into fixed blocks, every block has its own jump-ahead
+ * random stream, so a seed always generates the same population whatever the
+ * number of threads.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_POPULATION_H
+#define ELMERALMEIDAASSIGN3_POPULATION_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "columnar.h"
+#include "distribution.h"
+
+// households generated from a single random stream, a multiple of
+// COLUMNS_BLOCK_SIZE so no zone map is shared between two threads
+#define POPULATION_BLOCK_SIZE 65536
+
+// populations of at least this many households report their progress
+#define POPULATION_PROGRESS_MIN 1000000L
+
+// parts of a population held in memory, for printPopulationMemoryEstimate
+#define POPULATION_COLUMNS 1u  // the generated columnar population
+#define POPULATION_LIST 2u     // the linked list nodes and their indexes
+#define POPULATION_EPIDEMIC 4u // the epidemic state of every household
+
+typedef struct population_memory {
+  long columns;  // generated population, freed once it is in the linked list
+  long nodes;    // linked list nodes
+  long indexes;  // bitmap indexes of the linked list
+  long epidemic; // state of every household in a simulated epidemic
+} population_memory;
+
+typedef struct population_progress {
+  pthread_mutex_t lock; // the workers report their blocks as they finish
+  struct timespec start;
+  const char *action; // what is being done, "Generated" or "Added"
+  long households;    // size of the whole population
+  long done;          // households done so far
+  long nextReport;    // households to reach before the next report
+} population_progress;
+
+population_memory estimatePopulationMemory(long households);
+int printPopulationMemoryEstimate(long households, long populations,
+                                  unsigned parts);
+int generatePopulation(uint64_t seed, long households, int threads,
+                       const household_distribution *distribution,
+                       household_columns *columns);
+void generatePopulationSerial(uint64_t seed, long households,
+                              const household_distribution *distribution,
+                              household_columns *columns);
+int addPopulationToLinkedList(NodePtr *head,
+                              const household_columns *columns);
+int streamPopulationToFile(uint64_t seed, long households, int threads,
+                           const household_distribution *distribution,
+                           const char *fileName);
+
+/*
+ * Progress of large populations, shared by the generators
+ */
+population_progress *startPopulationProgress(population_progress *progress,
+                                             const char *action,
+                                             long households);
+void reportPopulationProgress(population_progress *progress, long households);
+void finishPopulationProgress(population_progress *progress);
+
+#endif // ELMERALMEIDAASSIGN3_POPULATION_H
@@ -0,0 +1,154 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the xoshiro256** random number
+ * generator defined in random.h
+ */
+
+#include "random.h"
+
+/**
+ * Rotate a 64-bit word to the left
+ *
+ * @param word
+ * @param bits
+ * @return the rotated word
+ */
+static uint64_t rotateLeft(uint64_t word, int bits) {
+  return (word << bits) | (word >> (64 - bits));
+}
+
+/**
+ * Seed a generator. The seed is spread over the whole state with splitmix64,
+ * so nearby seeds still give unrelated sequences.
+ *
+ * @param rng
+ * @param seed
+ */
+void seedRandom(random_context *rng, uint64_t seed) {
+  int i;
+  for (i = 0; i < 4; i++) {
+    uint64_t z = (seed += UINT64_C(0x9E3779B97F4A7C15));
+    z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+    rng->state[i] = z ^ (z >> 31);
+  }
+}
+
+/**
+ * Get the next 64 random bits
+ *
+ * @param rng
+ * @return random 64-bit number
+ */
+uint64_t nextRandom(random_context *rng) {
+  uint64_t *s = rng->state;
+  uint64_t result = rotateLeft(s[1] * 5, 7) * 9;
+  uint64_t t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotateLeft(s[3], 45);
+  return result;
+}
+
+/**
+ * Get a random number between 0 and bound - 1, every value equally likely.
+ * Uses a multiply and shift instead of a modulo, and only draws again in the
+ * rare case the value would be biased.
+ *
+ * @param rng
+ * @param bound number of possible values, at least 1
+ * @return random number below bound
+ */
+uint32_t boundedRandom(random_context *rng, uint32_t bound) {
+  uint64_t product = (nextRandom(rng) >> 32) * bound;
+  uint32_t low = (uint32_t)product;
+
+  if (low < bound) {
+    // the lowest (2^32 % bound) values would be picked too often
+    uint32_t threshold = (uint32_t)-bound % bound;
+    while (low < threshold) {
+      product = (nextRandom(rng) >> 32) * bound;
+      low = (uint32_t)product;
+    }
+  }
+  return (uint32_t)(product >> 32);
+}
+
+/**
+ * Jump the generator ahead by 2^128 numbers. Jumping a copy of a generator
+ * gives a new stream that never overlaps with the original one, which is how
+ * every block of the population gets its own stream.
+ *
+ * @param rng
+ */
+void jumpRandom(random_context *rng) {
+  static const uint64_t jump[4] = {
+      UINT64_C(0x180EC6D33CFD0ABA), UINT64_C(0xD5A61266F0C9392C),
+      UINT64_C(0xA9582618E03FC9AA), UINT64_C(0x39ABDC4529B1661C)};
+  uint64_t state[4] = {0, 0, 0, 0};
+  int i, bit;
+
+  for (i = 0; i < 4; i++) {
+    for (bit = 0; bit < 64; bit++) {
+      if (jump[i] & (UINT64_C(1) << bit)) {
+        state[0] ^= rng->state[0];
+        state[1] ^= rng->state[1];
+        state[2] ^= rng->state[2];
+        state[3] ^= rng->state[3];
+      }
+      nextRandom(rng);
+    }
+  }
+  for (i = 0; i < 4; i++)
+    rng->state[i] = state[i];
+}
+
+/**
+ * Seed a set of lanes from a generator. Every lane is seeded with its own
+ * number drawn from the generator, which moves on by RANDOM_LANES numbers.
+ *
+ * @param lanes
+ * @param rng
+ */
+void seedRandomLanes(random_lanes *lanes, random_context *rng) {
+  random_context lane;
+  int i;
+  for (i = 0; i < RANDOM_LANES; i++) {
+    seedRandom(&lane, nextRandom(rng));
+    lanes->s0[i] = lane.state[0];
+    lanes->s1[i] = lane.state[1];
+    lanes->s2[i] = lane.state[2];
+    lanes->s3[i] = lane.state[3];
+  }
+}
+
+/**
+ * Get the next 64 random bits of every lane at once. The loop has no branches
+ * and no dependency between lanes, so the compiler turns it into vector
+ * instructions.
+ *
+ * @param lanes
+ * @param values where to write RANDOM_LANES numbers
+ */
+void nextRandomLanes(random_lanes *lanes, uint64_t *values) {
+  int i;
+  for (i = 0; i < RANDOM_LANES; i++) {
+    uint64_t s1 = lanes->s1[i];
+    uint64_t t = s1 << 17;
+    uint64_t product = s1 * 5;
+    values[i] = ((product << 7) | (product >> 57)) * 9;
+
+    lanes->s2[i] ^= lanes->s0[i];
+    lanes->s3[i] ^= s1;
+    lanes->s1[i] = s1 ^ lanes->s2[i];
+    lanes->s0[i] ^= lanes->s3[i];
+    lanes->s2[i] ^= t;
+    lanes->s3[i] = (lanes->s3[i] << 45) | (lanes->s3[i] >> 19);
+  }
+}
@@ -0,0 +1,55 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the random number generator used to
+ * generate the population. Every generator takes its own context, so
+ * populations can be reproduced from a seed and generated from several threads
+ * at once.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_RANDOM_H
+#define ELMERALMEIDAASSIGN3_RANDOM_H
+
+#include <stdint.h>
+
+// xoshiro256** state
+typedef struct random_context {
+  uint64_t state[4];
+} random_context;
+
+// number of generators stepped together by nextRandomLanes
+#define RANDOM_LANES 8
+
+// xoshiro256** states of RANDOM_LANES generators, one array per state word so
+// the lanes are stepped with vector instructions
+typedef struct random_lanes {
+  uint64_t s0[RANDOM_LANES];
+  uint64_t s1[RANDOM_LANES];
+  uint64_t s2[RANDOM_LANES];
+  uint64_t s3[RANDOM_LANES];
+} random_lanes;
+
+void seedRandom(random_context *rng, uint64_t seed);
+uint64_t nextRandom(random_context *rng);
+uint32_t boundedRandom(random_context *rng, uint32_t bound);
+void jumpRandom(random_context *rng);
+
+void seedRandomLanes(random_lanes *lanes, random_context *rng);
+void nextRandomLanes(random_lanes *lanes, uint64_t *values);
+
+/**
+ * Scale 32 random bits down to a number between 0 and bound - 1 with a
+ * multiply and shift. Unlike boundedRandom it never draws again, so it has no
+ * branch; the bias is below bound / 2^32, under one in 200 million for the
+ * household ranges. Defined here so the batch generators can inline it.
+ *
+ * @param bits 32 random bits
+ * @param bound number of possible values
+ * @return number below bound
+ */
+static inline int scaleRandom(uint32_t bits, uint32_t bound) {
+  return (int)(((uint64_t)bits * bound) >> 32);
+}
+
+#endif // ELMERALMEIDAASSIGN3_RANDOM_H
@@ -0,0 +1,294 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the Monte Carlo replicate runner
+ * defined in replicates.h
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "columnar.h"
+#include "population.h"
+#include "replicates.h"
+
+typedef struct replicate_queue {
+  pthread_mutex_t lock;
+  random_context seeds; // draws the seed of every replicate, in order
+  long next;            // next replicate to hand out
+  long replicates;      // number of replicates to run
+  int failed;           // 1 once a worker ran out of memory
+} replicate_queue;
+
+typedef struct replicate_worker {
+  pthread_t thread;
+  replicate_queue *queue;
+  const household_distribution *distribution;
+  population_progress *progress; // NULL for a small run
+  replicate_summary summary;     // replicates run by the worker
+  int started;                   // 1 if the worker runs on its own thread
+} replicate_worker;
+
+/**
+ * Empty a summary of replicates
+ *
+ * @param summary
+ * @param households size of every replicate
+ */
+static void initReplicateSummary(replicate_summary *summary, long households) {
+  int i;
+  memset(summary, 0, sizeof(*summary));
+  summary->households = households;
+  for (i = 0; i < NUM_REGIONS; i++)
+    summary->region[i].casesMin = -1;
+  for (i = 0; i < NUM_TOWNS; i++)
+    summary->town[i].casesMin = -1;
+}
+
+/**
+ * Add the cases of one replicate, and the place they ranked at, to a summary
+ *
+ * @param item summary of the region or town
+ * @param place 0 for first
+ * @param cases
+ */
+static void addRanking(ranking_summary *item, int place, long cases) {
+  item->ranks[place]++;
+  item->casesTotal += cases;
+  item->casesSquares += (double)cases * cases;
+  if (item->casesMin < 0 || cases < item->casesMin)
+    item->casesMin = cases;
+  if (cases > item->casesMax)
+    item->casesMax = cases;
+}
+
+/**
+ * Add the summary of a region or town over some replicates to another one
+ *
+ * @param total
+ * @param item
+ */
+static void mergeRanking(ranking_summary *total, const ranking_summary *item) {
+  int i;
+  if (item->casesMin < 0) // no replicate
+    return;
+  for (i = 0; i < NUM_TOWNS; i++)
+    total->ranks[i] += item->ranks[i];
+  total->casesTotal += item->casesTotal;
+  total->casesSquares += item->casesSquares;
+  if (total->casesMin < 0 || item->casesMin < total->casesMin)
+    total->casesMin = item->casesMin;
+  if (item->casesMax > total->casesMax)
+    total->casesMax = item->casesMax;
+}
+
+/**
+ * Rank the regions and towns of a replicate and add them to a summary
+ *
+ * @param summary
+ * @param columns the replicate
+ */
+static void summarizeReplicate(replicate_summary *summary,
+                               const household_columns *columns) {
+  rank_cases region[NUM_REGIONS], town[NUM_TOWNS];
+  int place, i;
+
+  // the workers already run a replicate each, a single thread ranks it
+  rankColumnsPositiveTestedBasedOnRegion(columns, region, 1);
+  sortCaseRanking(region, NUM_REGIONS);
+  rankColumnsPositiveTestedBasedOnTown(columns, town, 1);
+  sortCaseRanking(town, NUM_TOWNS);
+
+  // the rankings are sorted, find who is at every place by name
+  for (place = 0; place < NUM_REGIONS; place++) {
+    for (i = 0; i < NUM_REGIONS; i++) {
+      if (strcmp(region[place].name, displayRegion(i)) == 0)
+        addRanking(&summary->region[i], place, region[place].cases);
+    }
+  }
+  for (place = 0; place < NUM_TOWNS; place++) {
+    for (i = 0; i < NUM_TOWNS; i++) {
+      if (strcmp(town[place].name,
+                 displayTown(i / (TOWN_RANGE + 1), i % (TOWN_RANGE + 1))) == 0)
+        addRanking(&summary->town[i], place, town[place].cases);
+    }
+  }
+  summary->replicates++;
+}
+
+/**
+ * Thread entry point -- generate and rank replicates until they have all been
+ * handed out. Every worker reuses a single columnar store, so the memory used
+ * only depends on the size of a replicate.
+ *
+ * @param argument the replicate worker
+ * @return NULL
+ */
+static void *runReplicateWorker(void *argument) {
+  replicate_worker *worker = argument;
+  replicate_queue *queue = worker->queue;
+  household_columns columns;
+  uint64_t seed;
+
+  initColumns(&columns);
+  if (!reserveColumns(&columns, worker->summary.households)) {
+    pthread_mutex_lock(&queue->lock);
+    queue->failed = 1;
+    pthread_mutex_unlock(&queue->lock);
+    freeColumns(&columns);
+    return NULL;
+  }
+
+  for (;;) {
+    // seeds are drawn in replicate order, whichever worker runs them
+    pthread_mutex_lock(&queue->lock);
+    if (queue->failed || queue->next == queue->replicates) {
+      pthread_mutex_unlock(&queue->lock);
+      break;
+    }
+    queue->next++;
+    seed = nextRandom(&queue->seeds);
+    pthread_mutex_unlock(&queue->lock);
+
+    generatePopulationSerial(seed, worker->summary.households,
+                             worker->distribution, &columns);
+    summarizeReplicate(&worker->summary, &columns);
+    reportPopulationProgress(worker->progress, worker->summary.households);
+  }
+
+  freeColumns(&columns);
+  return NULL;
+}
+
+/**
+ * Generate independent populations from several threads, rank the regions and
+ * towns of every one of them, and summarize the rankings as they come. No
+ * population is kept once it has been ranked.
+ *
+ * @param seed seed of the replicates, every replicate gets its own seed
+ * @param replicates number of populations to generate
+ * @param households size of every population
+ * @param threads number of threads to generate with
+ * @param distribution distribution of the households, NULL for uniform
+ * @param summary where to store the summary of every replicate
+ * @return 1 if every replicate has been run, 0 if out of memory
+ */
+int runReplicates(uint64_t seed, long replicates, long households, int threads,
+                  const household_distribution *distribution,
+                  replicate_summary *summary) {
+  replicate_queue queue;
+  replicate_worker *workers;
+  population_progress progress, *reporting;
+  int i, j;
+
+  initReplicateSummary(summary, households);
+  if (threads < 1)
+    threads = 1;
+  if (threads > replicates)
+    threads = replicates > 0 ? (int)replicates : 1;
+  workers = malloc(sizeof(*workers) * (size_t)threads);
+  if (workers == NULL)
+    return 0;
+
+  pthread_mutex_init(&queue.lock, NULL);
+  seedRandom(&queue.seeds, seed);
+  queue.next = 0;
+  queue.replicates = replicates;
+  queue.failed = 0;
+
+  // replicates are handed out one at a time, so a worker without a thread
+  // simply leaves its share to the others
+  reporting =
+      startPopulationProgress(&progress, "Ranked", replicates * households);
+  for (i = 0; i < threads; i++) {
+    workers[i].queue = &queue;
+    workers[i].distribution = distribution;
+    workers[i].progress = reporting;
+    initReplicateSummary(&workers[i].summary, households);
+  }
+  for (i = 1; i < threads; i++)
+    workers[i].started = pthread_create(&workers[i].thread, NULL,
+                                        runReplicateWorker, &workers[i]) == 0;
+  runReplicateWorker(&workers[0]);
+
+  for (i = 0; i < threads; i++) {
+    if (i > 0 && workers[i].started)
+      pthread_join(workers[i].thread, NULL);
+    summary->replicates += workers[i].summary.replicates;
+    for (j = 0; j < NUM_REGIONS; j++)
+      mergeRanking(&summary->region[j], &workers[i].summary.region[j]);
+    for (j = 0; j < NUM_TOWNS; j++)
+      mergeRanking(&summary->town[j], &workers[i].summary.town[j]);
+  }
+  if (!queue.failed)
+    finishPopulationProgress(reporting);
+  else if (reporting != NULL)
+    pthread_mutex_destroy(&reporting->lock);
+
+  pthread_mutex_destroy(&queue.lock);
+  free(workers);
+  return !queue.failed;
+}
+
+/**
+ * Print the places and cases of some regions or towns over every replicate
+ *
+ * @param items summaries of the regions or towns
+ * @param names names of the regions or towns
+ * @param count number of regions or towns
+ * @param replicates
+ */
+static void printRankingSummaries(const ranking_summary *items, char **names,
+                                  int count, long replicates) {
+  int i, place;
+
+  printf("%15s :", "");
+  for (place = 0; place < count; place++)
+    printf(" %5d%s", place + 1,
+           place == 0 ? "st" : place == 1 ? "nd" : place == 2 ? "rd" : "th");
+  printf(" : %12s %10s %10s %10s\n", "Mean cases", "Std dev", "Min", "Max");
+
+  for (i = 0; i < count; i++) {
+    double mean = (double)items[i].casesTotal / replicates;
+    double variance = items[i].casesSquares / replicates - mean * mean;
+
+    printf("%15s :", names[i]);
+    for (place = 0; place < count; place++)
+      printf(" %6.1f%%", 100.0 * items[i].ranks[place] / replicates);
+    printf(" : %12.1f %10.1f %10ld %10ld\n", mean,
+           variance > 0 ? sqrt(variance) : 0.0, items[i].casesMin,
+           items[i].casesMax);
+  }
+}
+
+/**
+ * Print how often every region and town ranked at every place, and how their
+ * cases spread, over every replicate
+ *
+ * @param summary
+ */
+void printReplicateSummary(const replicate_summary *summary) {
+  char *regions[NUM_REGIONS], *towns[NUM_TOWNS];
+  int i;
+
+  if (summary->replicates == 0)
+    return;
+  for (i = 0; i < NUM_REGIONS; i++)
+    regions[i] = displayRegion(i);
+  for (i = 0; i < NUM_TOWNS; i++)
+    towns[i] = displayTown(i / (TOWN_RANGE + 1), i % (TOWN_RANGE + 1));
+
+  printf("\nTested Positive for COVID-19 cases over %ld replicates of %ld "
+         "households:\n",
+         summary->replicates, summary->households);
+  printf("Region-wise Ranking:\n");
+  printRankingSummaries(summary->region, regions, NUM_REGIONS,
+                        summary->replicates);
+  printf("Town-wise Ranking:\n");
+  printRankingSummaries(summary->town, towns, NUM_TOWNS, summary->replicates);
+  puts("");
+}
@@ -0,0 +1,41 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the Monte Carlo replicate runner. Many
+ * independent populations are generated and ranked, and the rank and cases of
+ * every region and town are summarized over all of them, to tell a stable
+ * ranking from the luck of a single population.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_REPLICATES_H
+#define ELMERALMEIDAASSIGN3_REPLICATES_H
+
+#include <stdint.h>
+
+#include "distribution.h"
+
+#define MAX_REPLICATES 100000000L
+
+// rank and cases of a region or town over every replicate
+typedef struct ranking_summary {
+  long ranks[NUM_TOWNS]; // replicates where it ranked first, second, ...
+  long casesTotal;       // sum of the cases, for the mean
+  double casesSquares;   // sum of the squared cases, for the deviation
+  long casesMin;
+  long casesMax;
+} ranking_summary;
+
+typedef struct replicate_summary {
+  long replicates;  // number of replicates summarized
+  long households;  // size of every replicate
+  ranking_summary region[NUM_REGIONS];
+  ranking_summary town[NUM_TOWNS];
+} replicate_summary;
+
+int runReplicates(uint64_t seed, long replicates, long households, int threads,
+                  const household_distribution *distribution,
+                  replicate_summary *summary);
+void printReplicateSummary(const replicate_summary *summary);
+
+#endif // ELMERALMEIDAASSIGN3_REPLICATES_H
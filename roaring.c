@@ -0,0 +1,467 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the compressed bitmap defined in
+ * roaring.h
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "roaring.h"
+
+/**
+ * Count the bits set in a 64-bit word
+ *
+ * @param word
+ * @return number of bits set
+ */
+static int popcount64(uint64_t word) { return __builtin_popcountll(word); }
+
+/**
+ * Find the container holding the specified key.
+ *
+ * @param bitmap
+ * @param key upper 16 bits of a value
+ * @return index of the container, or -(insertion point + 1) if there is none
+ */
+static int findContainer(const roaring_bitmap *bitmap, uint16_t key) {
+  int low = 0, high = bitmap->count - 1;
+  while (low <= high) {
+    int middle = (low + high) / 2;
+    if (bitmap->containers[middle].key < key)
+      low = middle + 1;
+    else if (bitmap->containers[middle].key > key)
+      high = middle - 1;
+    else
+      return middle;
+  }
+  return -(low + 1);
+}
+
+/**
+ * Find the position of a value in an array container.
+ *
+ * @param container
+ * @param low lower 16 bits of a value
+ * @return index of the value, or -(insertion point + 1) if it is not there
+ */
+static int findArrayValue(const roaring_container *container, uint16_t low) {
+  int first = 0, last = container->cardinality - 1;
+  while (first <= last) {
+    int middle = (first + last) / 2;
+    if (container->values[middle] < low)
+      first = middle + 1;
+    else if (container->values[middle] > low)
+      last = middle - 1;
+    else
+      return middle;
+  }
+  return -(first + 1);
+}
+
+/**
+ * Release the memory held by a container
+ *
+ * @param container
+ */
+static void freeContainer(roaring_container *container) {
+  free(container->values);
+  free(container->words);
+  container->values = NULL;
+  container->words = NULL;
+}
+
+/**
+ * Set the bits of every value of a container in a 65536 bit buffer.
+ *
+ * @param container
+ * @param words buffer of ROARING_BITMAP_WORDS words
+ */
+static void orContainerIntoWords(const roaring_container *container,
+                                 uint64_t *words) {
+  int i;
+  if (container->words != NULL) {
+    for (i = 0; i < ROARING_BITMAP_WORDS; i++)
+      words[i] |= container->words[i];
+  } else {
+    for (i = 0; i < container->cardinality; i++)
+      words[container->values[i] >> 6] |= UINT64_C(1)
+                                          << (container->values[i] & 63);
+  }
+}
+
+/**
+ * Write the position of every bit set in a 65536 bit buffer, in order.
+ *
+ * @param words buffer of ROARING_BITMAP_WORDS words
+ * @param values where to write the positions
+ */
+static void wordsToValues(const uint64_t *words, uint16_t *values) {
+  int i, count = 0;
+  for (i = 0; i < ROARING_BITMAP_WORDS; i++) {
+    uint64_t word = words[i];
+    while (word) {
+      values[count++] = (uint16_t)(i * 64 + __builtin_ctzll(word));
+      word &= word - 1; // clear the lowest bit set
+    }
+  }
+}
+
+/**
+ * Build a container from a 65536 bit buffer, as an array if it is sparse
+ * enough. The buffer is taken over by the container.
+ *
+ * @param key
+ * @param words buffer of ROARING_BITMAP_WORDS words
+ * @param container to fill
+ * @return 1 if the container has been built, 0 if out of memory
+ */
+static int containerFromWords(uint16_t key, uint64_t *words,
+                              roaring_container *container) {
+  int i, cardinality = 0;
+  for (i = 0; i < ROARING_BITMAP_WORDS; i++)
+    cardinality += popcount64(words[i]);
+
+  memset(container, 0, sizeof(*container));
+  container->key = key;
+  container->cardinality = cardinality;
+  if (cardinality > ROARING_ARRAY_MAX) {
+    container->words = words;
+    return 1;
+  }
+
+  // sparse enough for an array container
+  container->capacity = cardinality;
+  if (cardinality > 0) {
+    container->values = malloc(sizeof(uint16_t) * (size_t)cardinality);
+    if (container->values == NULL) {
+      free(words);
+      return 0;
+    }
+    wordsToValues(words, container->values);
+  }
+  free(words);
+  return 1;
+}
+
+/**
+ * Insert an empty array container at the specified position.
+ *
+ * @param bitmap
+ * @param position
+ * @param key
+ * @return 1 if the container has been inserted, 0 if out of memory
+ */
+static int insertContainer(roaring_bitmap *bitmap, int position,
+                           uint16_t key) {
+  roaring_container *container;
+  if (bitmap->count == bitmap->capacity) {
+    int capacity = bitmap->capacity ? bitmap->capacity * 2 : 4;
+    roaring_container *grown = realloc(
+        bitmap->containers, sizeof(*grown) * (size_t)capacity);
+    if (grown == NULL)
+      return 0;
+    bitmap->containers = grown;
+    bitmap->capacity = capacity;
+  }
+  memmove(&bitmap->containers[position + 1], &bitmap->containers[position],
+          sizeof(*container) * (size_t)(bitmap->count - position));
+  bitmap->count++;
+
+  container = &bitmap->containers[position];
+  memset(container, 0, sizeof(*container));
+  container->key = key;
+  return 1;
+}
+
+/**
+ * Remove the container at the specified position
+ *
+ * @param bitmap
+ * @param position
+ */
+static void removeContainer(roaring_bitmap *bitmap, int position) {
+  freeContainer(&bitmap->containers[position]);
+  memmove(&bitmap->containers[position], &bitmap->containers[position + 1],
+          sizeof(*bitmap->containers) *
+              (size_t)(bitmap->count - position - 1));
+  bitmap->count--;
+}
+
+/**
+ * Initialize an empty bitmap
+ *
+ * @param bitmap
+ */
+void initRoaring(roaring_bitmap *bitmap) {
+  bitmap->containers = NULL;
+  bitmap->count = 0;
+  bitmap->capacity = 0;
+}
+
+/**
+ * Add a value to the bitmap
+ *
+ * @param bitmap
+ * @param value
+ * @return 1 if the value is in the bitmap, 0 if out of memory
+ */
+int addRoaring(roaring_bitmap *bitmap, uint32_t value) {
+  uint16_t key = (uint16_t)(value >> 16), low = (uint16_t)value;
+  roaring_container *container;
+  int position = findContainer(bitmap, key);
+
+  if (position < 0) {
+    position = -position - 1;
+    if (!insertContainer(bitmap, position, key))
+      return 0;
+  }
+  container = &bitmap->containers[position];
+
+  // a full array container becomes a bitmap container
+  if (container->words == NULL &&
+      container->cardinality == ROARING_ARRAY_MAX &&
+      findArrayValue(container, low) < 0) {
+    uint64_t *words = calloc(ROARING_BITMAP_WORDS, sizeof(*words));
+    if (words == NULL)
+      return 0;
+    orContainerIntoWords(container, words);
+    free(container->values);
+    container->values = NULL;
+    container->capacity = 0;
+    container->words = words;
+  }
+
+  if (container->words != NULL) {
+    uint64_t bit = UINT64_C(1) << (low & 63);
+    if (!(container->words[low >> 6] & bit)) {
+      container->words[low >> 6] |= bit;
+      container->cardinality++;
+    }
+  } else {
+    int index = findArrayValue(container, low);
+    if (index >= 0)
+      return 1; // already there
+    index = -index - 1;
+    // grow the array container as values are added
+    if (container->cardinality == container->capacity) {
+      int capacity = container->capacity ? container->capacity * 2 : 4;
+      uint16_t *grown;
+      if (capacity > ROARING_ARRAY_MAX)
+        capacity = ROARING_ARRAY_MAX;
+      grown = realloc(container->values, sizeof(*grown) * (size_t)capacity);
+      if (grown == NULL)
+        return 0;
+      container->values = grown;
+      container->capacity = capacity;
+    }
+    memmove(&container->values[index + 1], &container->values[index],
+            sizeof(*container->values) *
+                (size_t)(container->cardinality - index));
+    container->values[index] = low;
+    container->cardinality++;
+  }
+  return 1;
+}
+
+/**
+ * Remove a value from the bitmap. A bitmap container that becomes sparse
+ * goes back to an array container and an empty container is dropped.
+ *
+ * @param bitmap
+ * @param value
+ */
+void removeRoaring(roaring_bitmap *bitmap, uint32_t value) {
+  uint16_t key = (uint16_t)(value >> 16), low = (uint16_t)value;
+  roaring_container *container;
+  int position = findContainer(bitmap, key);
+
+  if (position < 0)
+    return;
+  container = &bitmap->containers[position];
+
+  if (container->words != NULL) {
+    uint64_t bit = UINT64_C(1) << (low & 63);
+    if (!(container->words[low >> 6] & bit))
+      return;
+    container->words[low >> 6] &= ~bit;
+    container->cardinality--;
+    // back to an array container -- on failure it just stays a bitmap
+    if (container->cardinality == ROARING_ARRAY_MAX) {
+      uint16_t *values = malloc(sizeof(*values) * ROARING_ARRAY_MAX);
+      if (values != NULL) {
+        wordsToValues(container->words, values);
+        free(container->words);
+        container->words = NULL;
+        container->values = values;
+        container->capacity = ROARING_ARRAY_MAX;
+      }
+    }
+  } else {
+    int index = findArrayValue(container, low);
+    if (index < 0)
+      return;
+    memmove(&container->values[index], &container->values[index + 1],
+            sizeof(*container->values) *
+                (size_t)(container->cardinality - index - 1));
+    container->cardinality--;
+  }
+
+  if (container->cardinality == 0)
+    removeContainer(bitmap, position);
+}
+
+/**
+ * Release the memory held by the bitmap and leave it empty
+ *
+ * @param bitmap
+ */
+void freeRoaring(roaring_bitmap *bitmap) {
+  int i;
+  for (i = 0; i < bitmap->count; i++)
+    freeContainer(&bitmap->containers[i]);
+  free(bitmap->containers);
+  initRoaring(bitmap);
+}
+
+/**
+ * Get the number of values in the bitmap
+ *
+ * @param bitmap
+ * @return number of values
+ */
+long cardinalityRoaring(const roaring_bitmap *bitmap) {
+  long cardinality = 0;
+  int i;
+  for (i = 0; i < bitmap->count; i++)
+    cardinality += bitmap->containers[i].cardinality;
+  return cardinality;
+}
+
+/**
+ * Count the values two containers have in common
+ *
+ * @param a
+ * @param b
+ * @return number of values in both containers
+ */
+static long andCardinalityContainer(const roaring_container *a,
+                                    const roaring_container *b) {
+  long cardinality = 0;
+  int i, j;
+
+  if (a->words != NULL && b->words != NULL) {
+    // both dense -- AND the words and count the bits
+    for (i = 0; i < ROARING_BITMAP_WORDS; i++)
+      cardinality += popcount64(a->words[i] & b->words[i]);
+  } else if (a->words != NULL || b->words != NULL) {
+    // probe the bitmap with every value of the array
+    const roaring_container *array = a->words != NULL ? b : a;
+    const uint64_t *words = a->words != NULL ? a->words : b->words;
+    for (i = 0; i < array->cardinality; i++)
+      cardinality += (words[array->values[i] >> 6] >> (array->values[i] & 63)) &
+                     1;
+  } else {
+    // both sparse -- merge the sorted arrays
+    for (i = 0, j = 0; i < a->cardinality && j < b->cardinality;) {
+      if (a->values[i] < b->values[j])
+        i++;
+      else if (a->values[i] > b->values[j])
+        j++;
+      else {
+        cardinality++;
+        i++;
+        j++;
+      }
+    }
+  }
+  return cardinality;
+}
+
+/**
+ * Count the values two bitmaps have in common, without building the
+ * intersection.
+ *
+ * @param a
+ * @param b
+ * @return number of values in both bitmaps
+ */
+long andCardinalityRoaring(const roaring_bitmap *a, const roaring_bitmap *b) {
+  long cardinality = 0;
+  int i = 0, j = 0;
+  while (i < a->count && j < b->count) {
+    if (a->containers[i].key < b->containers[j].key)
+      i++;
+    else if (a->containers[i].key > b->containers[j].key)
+      j++;
+    else
+      cardinality +=
+          andCardinalityContainer(&a->containers[i++], &b->containers[j++]);
+  }
+  return cardinality;
+}
+
+/**
+ * Append a container built from a 65536 bit buffer to the result, unless it
+ * turns out empty.
+ *
+ * @param result
+ * @param key
+ * @param words buffer, taken over by the result
+ * @return 1 on success, 0 if out of memory
+ */
+static int appendContainerFromWords(roaring_bitmap *result, uint16_t key,
+                                    uint64_t *words) {
+  roaring_container container;
+  if (!containerFromWords(key, words, &container))
+    return 0;
+  if (container.cardinality == 0) {
+    freeContainer(&container);
+    return 1;
+  }
+  if (!insertContainer(result, result->count, key)) {
+    freeContainer(&container);
+    return 0;
+  }
+  result->containers[result->count - 1] = container;
+  return 1;
+}
+
+/**
+ * Build the union of two bitmaps. The result must be initialized and distinct
+ * from both inputs; its previous values are replaced.
+ *
+ * @param a
+ * @param b
+ * @param result
+ * @return 1 on success, 0 if out of memory
+ */
+int orRoaring(const roaring_bitmap *a, const roaring_bitmap *b,
+              roaring_bitmap *result) {
+  int i = 0, j = 0;
+  freeRoaring(result);
+  while (i < a->count || j < b->count) {
+    uint64_t *words = calloc(ROARING_BITMAP_WORDS, sizeof(*words));
+    uint16_t key;
+    if (words == NULL)
+      return 0;
+    // take the smallest key left, from either or both bitmaps
+    if (j == b->count ||
+        (i < a->count && a->containers[i].key < b->containers[j].key)) {
+      key = a->containers[i].key;
+      orContainerIntoWords(&a->containers[i++], words);
+    } else if (i == a->count || b->containers[j].key < a->containers[i].key) {
+      key = b->containers[j].key;
+      orContainerIntoWords(&b->containers[j++], words);
+    } else {
+      key = a->containers[i].key;
+      orContainerIntoWords(&a->containers[i++], words);
+      orContainerIntoWords(&b->containers[j++], words);
+    }
+    if (!appendContainerFromWords(result, key, words))
+      return 0;
+  }
+  return 1;
+}
@@ -0,0 +1,49 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the compressed (roaring style) bitmap.
+ * Values are split on their upper 16 bits into containers; a container with
+ * few values keeps them in a sorted array, a dense one as 65536 bits.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_ROARING_H
+#define ELMERALMEIDAASSIGN3_ROARING_H
+
+#include <stdint.h>
+
+// an array container holding more values than this becomes a bitmap
+#define ROARING_ARRAY_MAX 4096
+#define ROARING_BITMAP_WORDS 1024
+
+typedef struct roaring_container {
+  uint16_t key;     // upper 16 bits shared by the values of the container
+  int cardinality;  // number of values in the container
+  int capacity;     // room in the array container
+  uint16_t *values; // sorted lower 16 bits, NULL for a bitmap container
+  uint64_t *words;  // 65536 bits, NULL for an array container
+} roaring_container;
+
+typedef struct roaring_bitmap {
+  roaring_container *containers; // sorted by key
+  int count;
+  int capacity;
+} roaring_bitmap;
+
+/*
+ * Bitmap administration
+ */
+void initRoaring(roaring_bitmap *bitmap);
+int addRoaring(roaring_bitmap *bitmap, uint32_t value);
+void removeRoaring(roaring_bitmap *bitmap, uint32_t value);
+void freeRoaring(roaring_bitmap *bitmap);
+
+/*
+ * Bitmap operations
+ */
+long cardinalityRoaring(const roaring_bitmap *bitmap);
+long andCardinalityRoaring(const roaring_bitmap *a, const roaring_bitmap *b);
+int orRoaring(const roaring_bitmap *a, const roaring_bitmap *b,
+              roaring_bitmap *result);
+
+#endif // ELMERALMEIDAASSIGN3_ROARING_H
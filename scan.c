@@ -0,0 +1,347 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the household scan defined in
+ * scan.h
+ */
+
+#include <stdlib.h>
+
+#include "nodepool.h"
+#include "packed.h"
+#include "parallel.h"
+#include "scan.h"
+
+// most threads counting and totalling the linked list
+static int scanThreads = 1;
+
+/**
+ * Get a predicate matching every household, to narrow down field by field
+ *
+ * @return predicate
+ */
+household_predicate anyHousehold() {
+  household_predicate predicate;
+  predicate.region = SCAN_ANY;
+  predicate.town = SCAN_ANY;
+  predicate.race = SCAN_ANY;
+  predicate.minTestedPositive = SCAN_ANY_POSITIVE;
+  return predicate;
+}
+
+/**
+ * Visit every household of the linked list matching a predicate, from the head
+ * of the list
+ *
+ * @param head
+ * @param predicate
+ * @param visit called with every matching household, NULL to only count them
+ * @param sink passed on to the visitor
+ * @return number of matching households
+ */
+long scanLinkedList(Node *head, const household_predicate *predicate,
+                    household_visitor visit, void *sink) {
+  household_predicate match = *predicate; // kept in registers by the loop
+  Node *ptr;
+  long count = 0;
+
+  if (visit == NULL) {
+    // counting only -- add up the matches instead of branching on them
+    for (ptr = head; ptr != NULL; ptr = ptr->next) {
+      household item = getNodeHousehold(ptr);
+      count += matchesHousehold(&match, &item);
+    }
+    return count;
+  }
+
+  for (ptr = head; ptr != NULL; ptr = ptr->next) {
+    household item = getNodeHousehold(ptr);
+    if (matchesHousehold(&match, &item)) {
+      visit(&item, sink);
+      count++;
+    }
+  }
+  return count;
+}
+
+/**
+ * Empty a batch of queries
+ *
+ * @param batch
+ */
+void initScanBatch(scan_batch *batch) { batch->count = 0; }
+
+/**
+ * Add a query to a batch, answered by the next scanLinkedListBatch
+ *
+ * @param batch
+ * @param predicate households of the query
+ * @param visit called with every matching household, NULL to only count them
+ * @param sink passed on to the visitor
+ * @return index of the query in the batch, -1 if the batch is full
+ */
+int addScanQuery(scan_batch *batch, const household_predicate *predicate,
+                 household_visitor visit, void *sink) {
+  scan_query *query;
+  if (batch->count == SCAN_MAX_QUERIES)
+    return -1;
+  query = &batch->queries[batch->count];
+  query->predicate = *predicate;
+  query->visit = visit;
+  query->sink = sink;
+  query->count = 0;
+  return batch->count++;
+}
+
+/**
+ * Answer every query of a batch in a single scan of the linked list, from the
+ * head of the list. Every household is checked against every query before
+ * moving on to the next one, so the list is only read once however many
+ * queries there are, and every query visits its households in list order.
+ *
+ * @param head
+ * @param batch
+ */
+void scanLinkedListBatch(Node *head, scan_batch *batch) {
+  household_predicate match[SCAN_MAX_QUERIES]; // copied out of the queries
+  long count[SCAN_MAX_QUERIES] = {0};
+  int queries = batch->count, i;
+  Node *ptr;
+
+  for (i = 0; i < queries; i++)
+    match[i] = batch->queries[i].predicate;
+
+  for (ptr = head; ptr != NULL; ptr = ptr->next) {
+    household item = getNodeHousehold(ptr);
+    for (i = 0; i < queries; i++) {
+      if (matchesHousehold(&match[i], &item)) {
+        if (batch->queries[i].visit != NULL)
+          batch->queries[i].visit(&item, batch->queries[i].sink);
+        count[i]++;
+      }
+    }
+  }
+
+  for (i = 0; i < queries; i++)
+    batch->queries[i].count = count[i];
+}
+
+/**
+ * Set the most threads counting and totalling the linked list
+ *
+ * @param threads at least 1
+ */
+void setScanThreads(int threads) { scanThreads = threads > 1 ? threads : 1; }
+
+/**
+ * Get the most threads counting and totalling the linked list
+ *
+ * @return number of threads
+ */
+int getScanThreads() { return scanThreads; }
+
+/**
+ * Check whether a block of nodes may hold households matching a predicate,
+ * according to its zone map
+ *
+ * @param slab
+ * @param zone block of the slab
+ * @param predicate
+ * @return the zone map of the block, NULL if the block can be skipped
+ */
+static const column_zone *zoneMayMatchPredicate(
+    long slab, long zone, const household_predicate *predicate) {
+  const column_zone *map = refreshNodePoolZone(slab, zone);
+  if (map == NULL ||
+      !zoneMayMatch(map, predicate->region, predicate->town, predicate->race,
+                    predicate->minTestedPositive))
+    return NULL;
+  return map;
+}
+
+/**
+ * Count the households of a range of slabs of the node pool matching a
+ * predicate, skipping the blocks of nodes their zone maps rule out
+ *
+ * @param first slab
+ * @param last slab after the range
+ * @param context household_predicate
+ * @param partial block_count of the thread
+ */
+static void countSlabs(long first, long last, const void *context,
+                       void *partial) {
+  household_predicate match = *(const household_predicate *)context;
+  block_count count = {0, 0};
+  long slab;
+  for (slab = first; slab < last; slab++) {
+    long nodes, zone, i;
+    const Node *node = getNodePoolSlab(slab, &nodes);
+    for (zone = 0; zone * COLUMNS_BLOCK_SIZE < nodes; zone++) {
+      long end = (zone + 1) * COLUMNS_BLOCK_SIZE;
+      if (zoneMayMatchPredicate(slab, zone, &match) == NULL) {
+        count.pruned++;
+        continue;
+      }
+      // free nodes keep a stale household, they are left out
+      for (i = zone * COLUMNS_BLOCK_SIZE; i < end && i < nodes; i++) {
+        household item = getNodeHousehold(&node[i]);
+        count.households +=
+            isNodeInUse(&node[i]) & matchesHousehold(&match, &item);
+      }
+    }
+  }
+  *(block_count *)partial = count;
+}
+
+/**
+ * Add the count of a thread to the count of the scan
+ *
+ * @param partial block_count of the thread
+ * @param result block_count
+ */
+static void mergeCount(const void *partial, void *result) {
+  const block_count *from = partial;
+  block_count *into = result;
+  into->households += from->households;
+  into->pruned += from->pruned;
+}
+
+/**
+ * Count the households of the linked list matching a predicate, from as many
+ * threads as setScanThreads allows. Every thread counts a range of slabs of
+ * the node pool, skipping the blocks of nodes their zone maps rule out.
+ *
+ * @param predicate
+ * @return number of matching households
+ */
+long countLinkedList(const household_predicate *predicate) {
+  long slabs = getNodePoolSlabs();
+  block_count count = {0, 0};
+  if (!runParallelRanges(slabs, SCAN_SLAB_GRAIN, scanThreads, countSlabs,
+                         mergeCount, predicate, &count, sizeof(count)))
+    countSlabs(0, slabs, predicate, &count); // no memory for the threads
+  addBlocksPruned(count.pruned);
+  return count.households;
+}
+
+/**
+ * Compare two matching nodes by list order, for qsort -- the node allocated
+ * last is the head of the list
+ *
+ * @param a Node pointer
+ * @param b Node pointer
+ * @return negative if a comes first in the list
+ */
+static int compareListOrder(const void *a, const void *b) {
+  long left = getNodeSequence(*(const Node *const *)a);
+  long right = getNodeSequence(*(const Node *const *)b);
+  return (left < right) - (left > right);
+}
+
+/**
+ * Collect the households of the linked list matching a predicate into a
+ * household_collection, in list order. The node pool is read block by block,
+ * skipping the blocks of nodes their zone maps rule out, and the matches are
+ * put back in list order from the allocation sequence of their nodes.
+ *
+ * @param predicate
+ * @param collection where to add the households, zeroed
+ * @return 1 if the households were collected, 0 if out of memory
+ */
+int collectLinkedList(const household_predicate *predicate,
+                      household_collection *collection) {
+  household_predicate match = *predicate;
+  long slabs = getNodePoolSlabs(), slab, count = 0, capacity = 0, pruned = 0;
+  const Node **matches = NULL;
+  long i;
+
+  for (slab = 0; slab < slabs; slab++) {
+    long nodes, zone;
+    const Node *node = getNodePoolSlab(slab, &nodes);
+    for (zone = 0; zone * COLUMNS_BLOCK_SIZE < nodes; zone++) {
+      long end = (zone + 1) * COLUMNS_BLOCK_SIZE;
+      if (zoneMayMatchPredicate(slab, zone, &match) == NULL) {
+        pruned++;
+        continue;
+      }
+      for (i = zone * COLUMNS_BLOCK_SIZE; i < end && i < nodes; i++) {
+        household item = getNodeHousehold(&node[i]);
+        if (!isNodeInUse(&node[i]) || !matchesHousehold(&match, &item))
+          continue;
+        if (count == capacity) {
+          long grown = capacity > 0 ? capacity * 2 : 64;
+          const Node **more =
+              realloc(matches, (size_t)grown * sizeof(*matches));
+          if (more == NULL) {
+            free(matches);
+            addBlocksPruned(pruned);
+            return 0;
+          }
+          matches = more;
+          capacity = grown;
+        }
+        matches[count++] = &node[i];
+      }
+    }
+  }
+  addBlocksPruned(pruned);
+
+  qsort(matches, (size_t)count, sizeof(*matches), compareListOrder);
+  for (i = 0; i < count; i++) {
+    household item = getNodeHousehold(matches[i]);
+    collectHousehold(&item, collection);
+  }
+  free(matches);
+  return !collection->failed;
+}
+
+/**
+ * Visitor printing a household as the next record of a listing
+ *
+ * @param item
+ * @param sink int number of records printed so far
+ */
+void printMatchingHousehold(const household *item, void *sink) {
+  int *ctr = sink;
+  printHouseholdItem(++*ctr, *item);
+}
+
+/**
+ * Visitor adding a copy of every household to a household_collection, which
+ * grows as needed. The sink must start zeroed.
+ *
+ * @param item
+ * @param sink household_collection
+ */
+void collectHousehold(const household *item, void *sink) {
+  household_collection *collection = sink;
+
+  if (collection->failed)
+    return;
+  if (collection->count == collection->capacity) {
+    long capacity = collection->capacity > 0 ? collection->capacity * 2 : 64;
+    household *items =
+        realloc(collection->items, (size_t)capacity * sizeof(household));
+    if (items == NULL) {
+      collection->failed = 1;
+      return;
+    }
+    collection->items = items;
+    collection->capacity = capacity;
+  }
+  collection->items[collection->count++] = *item;
+}
+
+/**
+ * Free the households of a collection and empty it
+ *
+ * @param collection
+ */
+void freeHouseholdCollection(household_collection *collection) {
+  free(collection->items);
+  collection->items = NULL;
+  collection->count = 0;
+  collection->capacity = 0;
+  collection->failed = 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the household scan. A scan visits every
+ * household of the linked list matching a predicate and hands it to a visitor,
+ * so printing, counting, aggregating and collecting share the same loop. A
+ * batch of queries is answered in a single scan, every household being
+ * checked against the predicate of every query.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_SCAN_H
+#define ELMERALMEIDAASSIGN3_SCAN_H
+
+#include <limits.h>
+
+#include "almeielm.h"
+
+// match every value of a field
+#define SCAN_ANY -1
+// match every number of adults tested positive, negative ones included
+#define SCAN_ANY_POSITIVE INT_MIN
+// slabs of the node pool worth a thread of their own
+#define SCAN_SLAB_GRAIN 16
+// most queries answered by a single scan
+#define SCAN_MAX_QUERIES 16
+
+typedef struct household_predicate {
+  int region;            // SCAN_ANY for every region
+  int town;              // SCAN_ANY for every town
+  int race;              // SCAN_ANY for every race
+  int minTestedPositive; // adults tested positive, SCAN_ANY_POSITIVE for any
+} household_predicate;
+
+// called with every matching household, and the sink given to the scan
+typedef void (*household_visitor)(const household *item, void *sink);
+
+// households collected by collectHousehold
+typedef struct household_collection {
+  household *items;
+  long count;
+  long capacity;
+  int failed; // set when the collection ran out of memory
+} household_collection;
+
+// a query of a batch, a listing or an aggregate over the matching households
+typedef struct scan_query {
+  household_predicate predicate;
+  household_visitor visit; // NULL to only count the matches
+  void *sink;              // passed on to the visitor
+  long count;              // matching households, set by the scan
+} scan_query;
+
+typedef struct scan_batch {
+  scan_query queries[SCAN_MAX_QUERIES];
+  int count;
+} scan_batch;
+
+/**
+ * Check whether a household matches a predicate. Every field is checked, with
+ * no early exit, so the check doesn't branch on the data.
+ *
+ * @param predicate
+ * @param item
+ * @return 1 if the household matches, 0 otherwise
+ */
+static inline int matchesHousehold(const household_predicate *predicate,
+                                   const household *item) {
+  return ((predicate->region == SCAN_ANY) |
+          (item->region == predicate->region)) &
+         ((predicate->town == SCAN_ANY) | (item->town == predicate->town)) &
+         ((predicate->race == SCAN_ANY) | (item->race == predicate->race)) &
+         (item->adultsTestedPositive >= predicate->minTestedPositive);
+}
+
+/*
+ * Scanning the linked list
+ */
+household_predicate anyHousehold();
+long scanLinkedList(Node *head, const household_predicate *predicate,
+                    household_visitor visit, void *sink);
+
+/*
+ * Answering a batch of queries in a single scan
+ */
+void initScanBatch(scan_batch *batch);
+int addScanQuery(scan_batch *batch, const household_predicate *predicate,
+                 household_visitor visit, void *sink);
+void scanLinkedListBatch(Node *head, scan_batch *batch);
+
+/*
+ * Counting the linked list from several threads. The node pool only ever holds
+ * the nodes of a single list, so these go through the pool instead of a list.
+ */
+void setScanThreads(int threads);
+int getScanThreads();
+long countLinkedList(const household_predicate *predicate);
+
+/*
+ * Collecting the linked list in list order, through the zone maps
+ */
+int collectLinkedList(const household_predicate *predicate,
+                      household_collection *collection);
+
+/*
+ * Ready-made visitors
+ */
+void printMatchingHousehold(const household *item, void *sink);
+void collectHousehold(const household *item, void *sink);
+void freeHouseholdCollection(household_collection *collection);
+
+#endif // ELMERALMEIDAASSIGN3_SCAN_H
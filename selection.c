@@ -0,0 +1,429 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the selection kernels defined in
+ * selection.h
+ *
+ * The vector kernels fill whole words of the selection, 64 rows at a time,
+ * and leave the rows past the last full word to the scalar kernels.
+ */
+
+#include <string.h>
+
+#include "selection.h"
+
+#if SELECTION_X86
+#include <immintrin.h>
+
+// compiled for AVX2 whatever the target, only run when the processor has it
+#define AVX2_KERNEL __attribute__((target("avx2")))
+#endif
+
+/**
+ * Get the kernels in use on this processor
+ *
+ * @return SELECTION_AVX2, SELECTION_SSE2 or SELECTION_SCALAR
+ */
+int getSelectionLevel() {
+#if SELECTION_X86
+  return __builtin_cpu_supports("avx2") ? SELECTION_AVX2 : SELECTION_SSE2;
+#else
+  return SELECTION_SCALAR;
+#endif
+}
+
+/**
+ * Select the rows of a byte column within a range, from a row on
+ *
+ * @param column
+ * @param start first row, at the start of a word of the selection
+ * @param rows number of rows of the column
+ * @param low
+ * @param high at least low
+ * @param selection
+ */
+static void selectByteRangeScalar(const unsigned char *column, long start,
+                                  long rows, unsigned low, unsigned high,
+                                  uint64_t *selection) {
+  unsigned span = high - low;
+  long row;
+  for (row = start; row < rows; row += 64) {
+    long end = rows - row < 64 ? rows - row : 64, i;
+    uint64_t bits = 0;
+    for (i = 0; i < end; i++)
+      bits |= (uint64_t)(column[row + i] - low <= span) << i;
+    selection[row / 64] = bits;
+  }
+}
+
+/**
+ * Select the rows of an int column within a range, from a row on
+ *
+ * @param column
+ * @param start first row, at the start of a word of the selection
+ * @param rows number of rows of the column
+ * @param low
+ * @param high at least low
+ * @param selection
+ */
+static void selectIntRangeScalar(const int *column, long start, long rows,
+                                 unsigned low, unsigned high,
+                                 uint64_t *selection) {
+  unsigned span = high - low;
+  long row;
+  for (row = start; row < rows; row += 64) {
+    long end = rows - row < 64 ? rows - row : 64, i;
+    uint64_t bits = 0;
+    for (i = 0; i < end; i++)
+      bits |= (uint64_t)((unsigned)column[row + i] - low <= span) << i;
+    selection[row / 64] = bits;
+  }
+}
+
+/**
+ * Select the rows of a byte column in a set of values, from a row on
+ *
+ * @param column
+ * @param start first row, at the start of a word of the selection
+ * @param rows number of rows of the column
+ * @param values
+ * @param count number of values
+ * @param selection
+ */
+static void selectByteInScalar(const unsigned char *column, long start,
+                               long rows, const unsigned *values, int count,
+                               uint64_t *selection) {
+  long row;
+  for (row = start; row < rows; row += 64) {
+    long end = rows - row < 64 ? rows - row : 64, i;
+    uint64_t bits = 0;
+    for (i = 0; i < end; i++) {
+      unsigned match = 0;
+      int k;
+      for (k = 0; k < count; k++)
+        match |= column[row + i] == values[k];
+      bits |= (uint64_t)match << i;
+    }
+    selection[row / 64] = bits;
+  }
+}
+
+/**
+ * Select the rows of an int column in a set of values, from a row on
+ *
+ * @param column
+ * @param start first row, at the start of a word of the selection
+ * @param rows number of rows of the column
+ * @param values
+ * @param count number of values
+ * @param selection
+ */
+static void selectIntInScalar(const int *column, long start, long rows,
+                              const unsigned *values, int count,
+                              uint64_t *selection) {
+  long row;
+  for (row = start; row < rows; row += 64) {
+    long end = rows - row < 64 ? rows - row : 64, i;
+    uint64_t bits = 0;
+    for (i = 0; i < end; i++) {
+      unsigned match = 0;
+      int k;
+      for (k = 0; k < count; k++)
+        match |= (unsigned)column[row + i] == values[k];
+      bits |= (uint64_t)match << i;
+    }
+    selection[row / 64] = bits;
+  }
+}
+
+#if SELECTION_X86
+/*
+ * SSE2 kernels, 16 bytes or 4 ints per comparison. SSE2 has no unsigned
+ * comparison, so bytes go through an unsigned minimum and ints are compared
+ * signed with their top bit flipped.
+ */
+
+static long selectByteRangeSse2(const unsigned char *column, long rows,
+                                unsigned low, unsigned high,
+                                uint64_t *selection) {
+  __m128i lows = _mm_set1_epi8((char)low);
+  __m128i spans = _mm_set1_epi8((char)(high - low));
+  long row;
+  for (row = 0; row + 64 <= rows; row += 64) {
+    uint64_t bits = 0;
+    int i;
+    for (i = 0; i < 4; i++) {
+      __m128i offsets = _mm_sub_epi8(
+          _mm_loadu_si128((const __m128i *)(column + row + 16 * i)), lows);
+      __m128i within =
+          _mm_cmpeq_epi8(_mm_min_epu8(offsets, spans), offsets);
+      bits |= (uint64_t)(unsigned)_mm_movemask_epi8(within) << (16 * i);
+    }
+    selection[row / 64] = bits;
+  }
+  return row;
+}
+
+static long selectIntRangeSse2(const int *column, long rows, unsigned low,
+                               unsigned high, uint64_t *selection) {
+  __m128i lows = _mm_set1_epi32((int)low);
+  __m128i flip = _mm_set1_epi32(INT_MIN);
+  __m128i spans = _mm_set1_epi32((int)((high - low) ^ 0x80000000u));
+  long row;
+  for (row = 0; row + 64 <= rows; row += 64) {
+    uint64_t bits = 0;
+    int i;
+    for (i = 0; i < 16; i++) {
+      __m128i offsets = _mm_xor_si128(
+          _mm_sub_epi32(
+              _mm_loadu_si128((const __m128i *)(column + row + 4 * i)), lows),
+          flip);
+      __m128i beyond = _mm_cmpgt_epi32(offsets, spans);
+      bits |= (uint64_t)(~_mm_movemask_ps(_mm_castsi128_ps(beyond)) & 0xf)
+              << (4 * i);
+    }
+    selection[row / 64] = bits;
+  }
+  return row;
+}
+
+static long selectByteInSse2(const unsigned char *column, long rows,
+                             const unsigned *values, int count,
+                             uint64_t *selection) {
+  long row;
+  for (row = 0; row + 64 <= rows; row += 64) {
+    uint64_t bits = 0;
+    int i, k;
+    for (i = 0; i < 4; i++) {
+      __m128i bytes = _mm_loadu_si128((const __m128i *)(column + row + 16 * i));
+      __m128i match = _mm_setzero_si128();
+      for (k = 0; k < count; k++)
+        match = _mm_or_si128(
+            match, _mm_cmpeq_epi8(bytes, _mm_set1_epi8((char)values[k])));
+      bits |= (uint64_t)(unsigned)_mm_movemask_epi8(match) << (16 * i);
+    }
+    selection[row / 64] = bits;
+  }
+  return row;
+}
+
+static long selectIntInSse2(const int *column, long rows,
+                            const unsigned *values, int count,
+                            uint64_t *selection) {
+  long row;
+  for (row = 0; row + 64 <= rows; row += 64) {
+    uint64_t bits = 0;
+    int i, k;
+    for (i = 0; i < 16; i++) {
+      __m128i ints = _mm_loadu_si128((const __m128i *)(column + row + 4 * i));
+      __m128i match = _mm_setzero_si128();
+      for (k = 0; k < count; k++)
+        match = _mm_or_si128(
+            match, _mm_cmpeq_epi32(ints, _mm_set1_epi32((int)values[k])));
+      bits |= (uint64_t)_mm_movemask_ps(_mm_castsi128_ps(match)) << (4 * i);
+    }
+    selection[row / 64] = bits;
+  }
+  return row;
+}
+
+/*
+ * AVX2 kernels, 32 bytes or 8 ints per comparison
+ */
+
+AVX2_KERNEL static long selectByteRangeAvx2(const unsigned char *column,
+                                            long rows, unsigned low,
+                                            unsigned high,
+                                            uint64_t *selection) {
+  __m256i lows = _mm256_set1_epi8((char)low);
+  __m256i spans = _mm256_set1_epi8((char)(high - low));
+  long row;
+  for (row = 0; row + 64 <= rows; row += 64) {
+    uint64_t bits = 0;
+    int i;
+    for (i = 0; i < 2; i++) {
+      __m256i offsets = _mm256_sub_epi8(
+          _mm256_loadu_si256((const __m256i *)(column + row + 32 * i)), lows);
+      __m256i within =
+          _mm256_cmpeq_epi8(_mm256_min_epu8(offsets, spans), offsets);
+      bits |= (uint64_t)(unsigned)_mm256_movemask_epi8(within) << (32 * i);
+    }
+    selection[row / 64] = bits;
+  }
+  return row;
+}
+
+AVX2_KERNEL static long selectIntRangeAvx2(const int *column, long rows,
+                                           unsigned low, unsigned high,
+                                           uint64_t *selection) {
+  __m256i lows = _mm256_set1_epi32((int)low);
+  __m256i spans = _mm256_set1_epi32((int)(high - low));
+  long row;
+  for (row = 0; row + 64 <= rows; row += 64) {
+    uint64_t bits = 0;
+    int i;
+    for (i = 0; i < 8; i++) {
+      __m256i offsets = _mm256_sub_epi32(
+          _mm256_loadu_si256((const __m256i *)(column + row + 8 * i)), lows);
+      __m256i within =
+          _mm256_cmpeq_epi32(_mm256_min_epu32(offsets, spans), offsets);
+      bits |= (uint64_t)(unsigned)_mm256_movemask_ps(
+                  _mm256_castsi256_ps(within))
+              << (8 * i);
+    }
+    selection[row / 64] = bits;
+  }
+  return row;
+}
+
+AVX2_KERNEL static long selectByteInAvx2(const unsigned char *column,
+                                         long rows, const unsigned *values,
+                                         int count, uint64_t *selection) {
+  long row;
+  for (row = 0; row + 64 <= rows; row += 64) {
+    uint64_t bits = 0;
+    int i, k;
+    for (i = 0; i < 2; i++) {
+      __m256i bytes =
+          _mm256_loadu_si256((const __m256i *)(column + row + 32 * i));
+      __m256i match = _mm256_setzero_si256();
+      for (k = 0; k < count; k++)
+        match = _mm256_or_si256(
+            match,
+            _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8((char)values[k])));
+      bits |= (uint64_t)(unsigned)_mm256_movemask_epi8(match) << (32 * i);
+    }
+    selection[row / 64] = bits;
+  }
+  return row;
+}
+
+AVX2_KERNEL static long selectIntInAvx2(const int *column, long rows,
+                                        const unsigned *values, int count,
+                                        uint64_t *selection) {
+  long row;
+  for (row = 0; row + 64 <= rows; row += 64) {
+    uint64_t bits = 0;
+    int i, k;
+    for (i = 0; i < 8; i++) {
+      __m256i ints =
+          _mm256_loadu_si256((const __m256i *)(column + row + 8 * i));
+      __m256i match = _mm256_setzero_si256();
+      for (k = 0; k < count; k++)
+        match = _mm256_or_si256(
+            match,
+            _mm256_cmpeq_epi32(ints, _mm256_set1_epi32((int)values[k])));
+      bits |= (uint64_t)(unsigned)_mm256_movemask_ps(
+                  _mm256_castsi256_ps(match))
+              << (8 * i);
+    }
+    selection[row / 64] = bits;
+  }
+  return row;
+}
+#endif
+
+/**
+ * Select the rows of a byte column whose value is within a range
+ *
+ * @param column
+ * @param rows
+ * @param low lowest value selected
+ * @param high highest value selected, SELECTION_NO_LIMIT for no limit
+ * @param selection bitmask of selectionWords(rows) words
+ */
+void selectByteRange(const unsigned char *column, long rows, unsigned low,
+                     unsigned high, uint64_t *selection) {
+  long done = 0;
+  if (low > high || low > UCHAR_MAX) {
+    memset(selection, 0, (size_t)selectionWords(rows) * sizeof(*selection));
+    return;
+  }
+  if (high > UCHAR_MAX)
+    high = UCHAR_MAX;
+#if SELECTION_X86
+  if (getSelectionLevel() == SELECTION_AVX2)
+    done = selectByteRangeAvx2(column, rows, low, high, selection);
+  else
+    done = selectByteRangeSse2(column, rows, low, high, selection);
+#endif
+  selectByteRangeScalar(column, done, rows, low, high, selection);
+}
+
+/**
+ * Select the rows of an int column whose value is within a range
+ *
+ * @param column
+ * @param rows
+ * @param low lowest value selected
+ * @param high highest value selected, SELECTION_NO_LIMIT for no limit
+ * @param selection bitmask of selectionWords(rows) words
+ */
+void selectIntRange(const int *column, long rows, unsigned low, unsigned high,
+                    uint64_t *selection) {
+  long done = 0;
+  if (low > high) {
+    memset(selection, 0, (size_t)selectionWords(rows) * sizeof(*selection));
+    return;
+  }
+#if SELECTION_X86
+  if (getSelectionLevel() == SELECTION_AVX2)
+    done = selectIntRangeAvx2(column, rows, low, high, selection);
+  else
+    done = selectIntRangeSse2(column, rows, low, high, selection);
+#endif
+  selectIntRangeScalar(column, done, rows, low, high, selection);
+}
+
+/**
+ * Select the rows of a byte column whose value is in a set
+ *
+ * @param column
+ * @param rows
+ * @param values
+ * @param count number of values, up to SELECTION_MAX_IN
+ * @param selection bitmask of selectionWords(rows) words
+ */
+void selectByteIn(const unsigned char *column, long rows,
+                  const unsigned *values, int count, uint64_t *selection) {
+  unsigned bytes[SELECTION_MAX_IN];
+  int kept = 0, k;
+  long done = 0;
+
+  // values above a byte never match
+  for (k = 0; k < count && k < SELECTION_MAX_IN; k++) {
+    if (values[k] <= UCHAR_MAX)
+      bytes[kept++] = values[k];
+  }
+#if SELECTION_X86
+  if (getSelectionLevel() == SELECTION_AVX2)
+    done = selectByteInAvx2(column, rows, bytes, kept, selection);
+  else
+    done = selectByteInSse2(column, rows, bytes, kept, selection);
+#endif
+  selectByteInScalar(column, done, rows, bytes, kept, selection);
+}
+
+/**
+ * Select the rows of an int column whose value is in a set
+ *
+ * @param column
+ * @param rows
+ * @param values
+ * @param count number of values, up to SELECTION_MAX_IN
+ * @param selection bitmask of selectionWords(rows) words
+ */
+void selectIntIn(const int *column, long rows, const unsigned *values,
+                 int count, uint64_t *selection) {
+  long done = 0;
+  if (count > SELECTION_MAX_IN)
+    count = SELECTION_MAX_IN;
+#if SELECTION_X86
+  if (getSelectionLevel() == SELECTION_AVX2)
+    done = selectIntInAvx2(column, rows, values, count, selection);
+  else
+    done = selectIntInSse2(column, rows, values, count, selection);
+#endif
+  selectIntInScalar(column, done, rows, values, count, selection);
+}
@@ -0,0 +1,61 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the selection kernels. A kernel
+ * compares a column of the columnar store against a range or a set of values
+ * and sets one bit per matching row in a selection bitmask, so selections can
+ * be combined 64 rows at a time. They answer the --filter scans of a columnar
+ * population; the menu listings read the linked list nodes, which hold no
+ * columns.
+ *
+ * On x86-64 the kernels compare 16 rows per instruction with SSE2, or 32 with
+ * AVX2 when the processor has it. Elsewhere, or when built with
+ * SCALAR_KERNELS, the scalar kernels run instead.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_SELECTION_H
+#define ELMERALMEIDAASSIGN3_SELECTION_H
+
+#include <limits.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(SCALAR_KERNELS)
+#define SELECTION_X86 1
+#else
+#define SELECTION_X86 0
+#endif
+
+// kernels in use
+#define SELECTION_SCALAR 0
+#define SELECTION_SSE2 1
+#define SELECTION_AVX2 2
+
+// upper bound of a range without one, for thresholds
+#define SELECTION_NO_LIMIT UINT_MAX
+// values of an IN set compared one at a time
+#define SELECTION_MAX_IN 8
+
+/**
+ * Get the number of words of the selection bitmask of a number of rows
+ *
+ * @param rows
+ * @return words
+ */
+static inline long selectionWords(long rows) { return (rows + 63) / 64; }
+
+/*
+ * Kernels -- values are compared as unsigned, so a negative value is above
+ * every other value, and the rows past the last one are never selected
+ */
+int getSelectionLevel();
+void selectByteRange(const unsigned char *column, long rows, unsigned low,
+                     unsigned high, uint64_t *selection);
+void selectIntRange(const int *column, long rows, unsigned low, unsigned high,
+                    uint64_t *selection);
+void selectByteIn(const unsigned char *column, long rows,
+                  const unsigned *values, int count, uint64_t *selection);
+void selectIntIn(const int *column, long rows, const unsigned *values,
+                 int count, uint64_t *selection);
+
+#endif // ELMERALMEIDAASSIGN3_SELECTION_H
@@ -0,0 +1,222 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the top-K query defined in topk.h
+ */
+
+#include <stdlib.h>
+
+#include "nodepool.h"
+#include "packed.h"
+#include "parallel.h"
+#include "topk.h"
+
+typedef struct topk_query {
+  household_predicate predicate;
+  int order;
+  long k;
+} topk_query;
+
+// households kept by a thread, or by the query once the threads are merged
+typedef struct topk_heap {
+  const topk_query *query;
+  topk_entry *entries; // entries[0] ranks lowest
+  long count;
+  int failed; // set when the heap couldn't be allocated
+} topk_heap;
+
+/**
+ * Check whether a household ranks above another. The share of positives is
+ * compared by cross-multiplying, a household without tests having none; ties
+ * go to the most positives, then to the lowest node.
+ *
+ * @param a
+ * @param b
+ * @param order TOPK_ order
+ * @return 1 if a ranks above b, 0 otherwise
+ */
+static int ranksAbove(const topk_entry *a, const topk_entry *b, int order) {
+  if (order == TOPK_RATIO) {
+    long left = (long)a->item.adultsTestedPositive *
+                (b->item.tested > 0 ? b->item.tested : 1);
+    long right = (long)b->item.adultsTestedPositive *
+                 (a->item.tested > 0 ? a->item.tested : 1);
+    if (a->item.tested == 0)
+      left = 0;
+    if (b->item.tested == 0)
+      right = 0;
+    if (left != right)
+      return left > right;
+  }
+  if (a->item.adultsTestedPositive != b->item.adultsTestedPositive)
+    return a->item.adultsTestedPositive > b->item.adultsTestedPositive;
+  return a->id < b->id;
+}
+
+/**
+ * Move the entry at the root of a heap down to its place, the lowest ranking
+ * entry at the root
+ *
+ * @param heap
+ * @param count entries of the heap
+ * @param order TOPK_ order
+ */
+static void siftDown(topk_entry *heap, long count, int order) {
+  topk_entry entry = heap[0];
+  long parent = 0, child;
+  while ((child = 2 * parent + 1) < count) {
+    if (child + 1 < count && ranksAbove(&heap[child], &heap[child + 1], order))
+      child++;
+    if (!ranksAbove(&entry, &heap[child], order))
+      break;
+    heap[parent] = heap[child];
+    parent = child;
+  }
+  heap[parent] = entry;
+}
+
+/**
+ * Move the last entry of a heap up to its place
+ *
+ * @param heap
+ * @param count entries of the heap
+ * @param order TOPK_ order
+ */
+static void siftUp(topk_entry *heap, long count, int order) {
+  topk_entry entry = heap[count - 1];
+  long child = count - 1;
+  while (child > 0) {
+    long parent = (child - 1) / 2;
+    if (!ranksAbove(&heap[parent], &entry, order))
+      break;
+    heap[child] = heap[parent];
+    child = parent;
+  }
+  heap[child] = entry;
+}
+
+/**
+ * Offer a household to a heap of the best K -- it is kept while the heap isn't
+ * full, or when it ranks above the worst household kept, which it replaces
+ *
+ * @param heap
+ * @param entry
+ */
+static void offerEntry(topk_heap *heap, const topk_entry *entry) {
+  int order = heap->query->order;
+  if (heap->count < heap->query->k) {
+    heap->entries[heap->count++] = *entry;
+    siftUp(heap->entries, heap->count, order);
+  } else if (ranksAbove(entry, &heap->entries[0], order)) {
+    heap->entries[0] = *entry;
+    siftDown(heap->entries, heap->count, order);
+  }
+}
+
+/**
+ * Keep the best K households of a range of slabs of the node pool matching the
+ * predicate of a query
+ *
+ * @param first slab
+ * @param last slab after the range
+ * @param context topk_query
+ * @param partial topk_heap of the thread
+ */
+static void topSlabs(long first, long last, const void *context,
+                     void *partial) {
+  const topk_query *query = context;
+  household_predicate match = query->predicate;
+  topk_heap *heap = partial;
+  long slab;
+
+  heap->query = query;
+  heap->entries = malloc(sizeof(topk_entry) * (size_t)query->k);
+  if (heap->entries == NULL) {
+    heap->failed = 1;
+    return;
+  }
+  for (slab = first; slab < last; slab++) {
+    long nodes, i;
+    const Node *node = getNodePoolSlab(slab, &nodes);
+    for (i = 0; i < nodes; i++) {
+      topk_entry entry;
+      if (!isNodeInUse(&node[i]))
+        continue;
+      entry.item = getNodeHousehold(&node[i]);
+      if (matchesHousehold(&match, &entry.item)) {
+        entry.id = node[i].id;
+        offerEntry(heap, &entry);
+      }
+    }
+  }
+}
+
+/**
+ * Offer the households kept by a thread to the heap of the query
+ *
+ * @param partial topk_heap of the thread, freed
+ * @param result topk_heap of the query
+ */
+static void mergeTops(const void *partial, void *result) {
+  const topk_heap *from = partial;
+  topk_heap *into = result;
+  long i;
+
+  into->failed |= from->failed;
+  for (i = 0; i < from->count; i++)
+    offerEntry(into, &from->entries[i]);
+  free(from->entries);
+}
+
+/**
+ * Find the K households of the linked list matching a predicate that rank
+ * highest, from as many threads as setScanThreads allows. It takes O(n log K)
+ * time and memory for K households per thread.
+ *
+ * @param predicate
+ * @param order TOPK_POSITIVE or TOPK_RATIO
+ * @param k most households to find, at least 1
+ * @param top where to store the households, room for k, best first
+ * @return number of households found, -1 if out of memory
+ */
+long topLinkedList(const household_predicate *predicate, int order, long k,
+                   household *top) {
+  long slabs = getNodePoolSlabs(), inUse = getNodePoolStats().nodesInUse;
+  topk_query query;
+  topk_heap result = {NULL, NULL, 0, 0};
+  long count, i;
+
+  query.predicate = *predicate;
+  query.order = order;
+  // there are never more than the households in use to keep
+  query.k = k < inUse ? k : inUse;
+  if (query.k < 1)
+    return 0;
+  result.query = &query;
+  result.entries = malloc(sizeof(topk_entry) * (size_t)query.k);
+  if (result.entries == NULL)
+    return -1;
+
+  if (!runParallelRanges(slabs, SCAN_SLAB_GRAIN, getScanThreads(), topSlabs,
+                         mergeTops, &query, &result, sizeof(topk_heap))) {
+    // no memory for the threads -- keep the best of every slab here
+    topk_heap heap = {NULL, NULL, 0, 0};
+    topSlabs(0, slabs, &query, &heap);
+    mergeTops(&heap, &result);
+  }
+  if (result.failed) {
+    free(result.entries);
+    return -1;
+  }
+
+  // take the lowest ranking household off the root, filling in from the end
+  count = result.count;
+  for (i = count - 1; i >= 0; i--) {
+    top[i] = result.entries[0].item;
+    result.entries[0] = result.entries[i];
+    siftDown(result.entries, i, order);
+  }
+  free(result.entries);
+  return count;
+}
@@ -0,0 +1,32 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the top-K query: the K households of
+ * the linked list matching a predicate that rank highest, by most adults
+ * tested positive or by the highest share of the tested adults positive.
+ *
+ * Every thread keeps the best K households of its range of the node pool in a
+ * bounded heap whose root is the worst of them, so a household only costs a
+ * comparison with the root, and O(log K) when it replaces it. The heaps of the
+ * threads are merged into one at the end.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_TOPK_H
+#define ELMERALMEIDAASSIGN3_TOPK_H
+
+#include "scan.h"
+
+// orders of a top-K query
+#define TOPK_POSITIVE 0 // most adults tested positive
+#define TOPK_RATIO 1    // highest share of the tested adults positive
+
+typedef struct topk_entry {
+  household item;
+  long id; // node of the household, breaks ties so any thread count agrees
+} topk_entry;
+
+long topLinkedList(const household_predicate *predicate, int order, long k,
+                   household *top);
+
+#endif // ELMERALMEIDAASSIGN3_TOPK_H
@@ -0,0 +1,94 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the region, town and race triplet
+ * index defined in tripletindex.h
+ */
+
+#include <stddef.h>
+
+#include "packed.h"
+#include "tripletindex.h"
+
+#define NUM_TOWNS_PER_REGION (TOWN_RANGE + 1)
+#define NUM_RACES (RACE_RANGE + 1)
+
+// first node of every triplet, chained through tripletNext, newest first
+static Node *buckets[NUM_REGIONS][NUM_TOWNS_PER_REGION][NUM_RACES];
+
+/**
+ * Check if a triplet has a bucket in the index. Households created with an
+ * unknown region, town or race are left out of the index.
+ *
+ * @param region
+ * @param town
+ * @param race
+ * @return 1 if the triplet is indexed, 0 otherwise
+ */
+int isIndexedTriplet(int region, int town, int race) {
+  return region >= 0 && region < NUM_REGIONS && town >= 0 &&
+         town < NUM_TOWNS_PER_REGION && race >= 0 && race < NUM_RACES;
+}
+
+/**
+ * Add a node to the front of its triplet bucket -- called for every node added
+ * to the linked list.
+ *
+ * @param node
+ */
+void indexTripletNode(Node *node) {
+  household item = getNodeHousehold(node);
+  int region = item.region, town = item.town, race = item.race;
+
+  node->tripletNext = NULL;
+  if (!isIndexedTriplet(region, town, race))
+    return;
+
+  node->tripletNext = buckets[region][town][race];
+  buckets[region][town][race] = node;
+}
+
+/**
+ * Detach every node of a triplet from the index. The nodes stay chained
+ * through tripletNext so the caller can unlink them from the list.
+ *
+ * @param region
+ * @param town
+ * @param race
+ * @return the first node of the triplet, NULL if there is none
+ */
+Node *takeTripletNodes(int region, int town, int race) {
+  Node *nodes;
+  if (!isIndexedTriplet(region, town, race))
+    return NULL;
+
+  nodes = buckets[region][town][race];
+  buckets[region][town][race] = NULL;
+  return nodes;
+}
+
+/**
+ * Empty every bucket of the index -- called when the whole list is released.
+ */
+void clearTripletIndex() {
+  int region, town, race;
+  for (region = 0; region < NUM_REGIONS; region++)
+    for (town = 0; town < NUM_TOWNS_PER_REGION; town++)
+      for (race = 0; race < NUM_RACES; race++)
+        buckets[region][town][race] = NULL;
+}
+
+/**
+ * Get the nodes of a triplet, the chain follows tripletNext.
+ *
+ * @param region
+ * @param town
+ * @param race
+ * @return the first node of the triplet, NULL if there is none
+ */
+Node *getTripletNodes(int region, int town, int race) {
+  if (!isIndexedTriplet(region, town, race))
+    return NULL;
+  return buckets[region][town][race];
+}
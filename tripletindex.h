@@ -0,0 +1,29 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the region, town and race triplet
+ * index. Every linked list node is chained into a bucket of a dense
+ * 3 x 2 x 5 table, so the households of a triplet can be reached without
+ * walking the whole list.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_TRIPLETINDEX_H
+#define ELMERALMEIDAASSIGN3_TRIPLETINDEX_H
+
+#include "almeielm.h"
+
+/*
+ * Triplet index administration
+ */
+int isIndexedTriplet(int region, int town, int race);
+void indexTripletNode(Node *node);
+Node *takeTripletNodes(int region, int town, int race);
+void clearTripletIndex();
+
+/*
+ * Triplet lookup
+ */
+Node *getTripletNodes(int region, int town, int race);
+
+#endif // ELMERALMEIDAASSIGN3_TRIPLETINDEX_H
@@ -0,0 +1,337 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the implementation of the workload driver defined in
+ * workload.h
+ *
+ * Operations arrive at random (exponential) intervals at the requested rate,
+ * and their latency is measured from their arrival, so an operation held up
+ * by a slow one before it is charged for the wait, like a real client would
+ * see it.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bitmapindex.h"
+#include "linkedlist.h"
+#include "nodepool.h"
+#include "workload.h"
+
+// waits shorter than this are spun, sleeping would wake up too late
+#define WORKLOAD_SPIN_NANOSECONDS 200000L
+// latencies are counted in buckets of 16 per power of two, within 7%
+#define LATENCY_SUB_BITS 4
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BITS)
+#define LATENCY_BUCKETS (64 * LATENCY_SUB_BUCKETS)
+
+typedef struct latency_histogram {
+  long counts[LATENCY_BUCKETS];
+  long operations;
+  double total; // nanoseconds, for the mean
+  long max;     // nanoseconds
+} latency_histogram;
+
+static const char *operationNames[WORKLOAD_OPERATIONS] = {
+    "add", "delete", "filter", "count", "rank"};
+
+/**
+ * Set a workload to its default mix: mostly adds and queries, with the odd
+ * triplet delete
+ *
+ * @param workload
+ */
+void initWorkloadOptions(workload_options *workload) {
+  workload->weights[WORKLOAD_ADD] = 60;
+  workload->weights[WORKLOAD_DELETE] = 1;
+  workload->weights[WORKLOAD_FILTER] = 10;
+  workload->weights[WORKLOAD_COUNT] = 24;
+  workload->weights[WORKLOAD_RANK] = 5;
+  workload->operations = DEFAULT_WORKLOAD_OPERATIONS;
+  workload->rate = 0;
+}
+
+/**
+ * Parse the mix of a workload, given as the weight of every kind of
+ * operation, for example "add=60,delete=1,filter=10,count=24,rank=5". Kinds
+ * left out of the mix are not run.
+ *
+ * @param mix
+ * @param workload where to store the weights
+ * @return 1 if the mix is valid, 0 otherwise
+ */
+int parseWorkloadMix(const char *mix, workload_options *workload) {
+  unsigned weights[WORKLOAD_OPERATIONS] = {0}, total = 0;
+  const char *ptr = mix;
+  int i;
+
+  while (*ptr != '\0') {
+    size_t length = strcspn(ptr, "=");
+    char *end;
+    unsigned long weight;
+
+    for (i = 0; i < WORKLOAD_OPERATIONS; i++) {
+      if (strlen(operationNames[i]) == length &&
+          strncmp(ptr, operationNames[i], length) == 0)
+        break;
+    }
+    if (i == WORKLOAD_OPERATIONS || ptr[length] != '=' ||
+        ptr[length + 1] == '-')
+      return 0;
+    weight = strtoul(ptr + length + 1, &end, 10);
+    if (end == ptr + length + 1 || (*end != ',' && *end != '\0') ||
+        weight > 1000000)
+      return 0;
+
+    weights[i] = (unsigned)weight;
+    total += weights[i];
+    ptr = *end == ',' ? end + 1 : end;
+  }
+  if (total == 0)
+    return 0;
+
+  memcpy(workload->weights, weights, sizeof(weights));
+  return 1;
+}
+
+/**
+ * Get the nanoseconds between two points in time
+ *
+ * @param start
+ * @param end
+ * @return nanoseconds elapsed, 0 if end is before start
+ */
+static long nanosecondsBetween(const struct timespec *start,
+                               const struct timespec *end) {
+  long elapsed = (end->tv_sec - start->tv_sec) * 1000000000L +
+                 (end->tv_nsec - start->tv_nsec);
+  return elapsed > 0 ? elapsed : 0;
+}
+
+/**
+ * Move a point in time forward
+ *
+ * @param time
+ * @param nanoseconds
+ */
+static void addNanoseconds(struct timespec *time, long nanoseconds) {
+  time->tv_sec += nanoseconds / 1000000000L;
+  time->tv_nsec += nanoseconds % 1000000000L;
+  if (time->tv_nsec >= 1000000000L) {
+    time->tv_sec++;
+    time->tv_nsec -= 1000000000L;
+  }
+}
+
+/**
+ * Wait for a point in time. The thread sleeps through most of a long wait and
+ * spins through the end of it, so the operation starts on time instead of
+ * whenever the scheduler wakes the thread up.
+ *
+ * @param time
+ */
+static void waitUntil(const struct timespec *time) {
+  struct timespec now, wake;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  if (nanosecondsBetween(&now, time) > WORKLOAD_SPIN_NANOSECONDS) {
+    wake = now;
+    addNanoseconds(&wake, nanosecondsBetween(&now, time) -
+                              WORKLOAD_SPIN_NANOSECONDS);
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL);
+  }
+  do
+    clock_gettime(CLOCK_MONOTONIC, &now);
+  while (nanosecondsBetween(&now, time) > 0);
+}
+
+/**
+ * Get the latency bucket of a number of nanoseconds -- values below 16 have a
+ * bucket each, then every power of two is split into 16 buckets
+ *
+ * @param nanoseconds
+ * @return bucket
+ */
+static int latencyBucket(long nanoseconds) {
+  int exponent = 0;
+  if (nanoseconds < LATENCY_SUB_BUCKETS)
+    return (int)nanoseconds;
+  while ((nanoseconds >> exponent) >= 2 * LATENCY_SUB_BUCKETS)
+    exponent++;
+  return (exponent + 1) * LATENCY_SUB_BUCKETS +
+         (int)((nanoseconds >> exponent) - LATENCY_SUB_BUCKETS);
+}
+
+/**
+ * Get the largest number of nanoseconds of a latency bucket
+ *
+ * @param bucket
+ * @return nanoseconds
+ */
+static long latencyBucketLimit(int bucket) {
+  int exponent = bucket / LATENCY_SUB_BUCKETS - 1;
+  if (bucket < LATENCY_SUB_BUCKETS)
+    return bucket;
+  return ((long)(bucket % LATENCY_SUB_BUCKETS + LATENCY_SUB_BUCKETS + 1)
+          << exponent) -
+         1;
+}
+
+/**
+ * Add the latency of an operation to a histogram
+ *
+ * @param histogram
+ * @param nanoseconds
+ */
+static void recordLatency(latency_histogram *histogram, long nanoseconds) {
+  histogram->counts[latencyBucket(nanoseconds)]++;
+  histogram->operations++;
+  histogram->total += (double)nanoseconds;
+  if (nanoseconds > histogram->max)
+    histogram->max = nanoseconds;
+}
+
+/**
+ * Get a percentile of the latencies of a histogram
+ *
+ * @param histogram
+ * @param percentile between 0 and 100
+ * @return nanoseconds at or under which the percentile of operations finished
+ */
+static long latencyPercentile(const latency_histogram *histogram,
+                              double percentile) {
+  long rank = (long)ceil(histogram->operations * percentile / 100);
+  long seen = 0;
+  int bucket;
+
+  if (rank < 1)
+    rank = 1;
+  for (bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+    seen += histogram->counts[bucket];
+    if (seen >= rank) {
+      long limit = latencyBucketLimit(bucket);
+      return limit < histogram->max ? limit : histogram->max;
+    }
+  }
+  return histogram->max;
+}
+
+/**
+ * Run a single operation of a workload on the linked list
+ *
+ * @param head
+ * @param operation kind of operation
+ * @param rng
+ * @return 1 if the operation has been run, 0 if out of memory
+ */
+static int runOperation(NodePtr *head, int operation, random_context *rng) {
+  rank_cases region[NUM_REGIONS], town[NUM_TOWNS];
+  int regionNumber = generateRegion(rng);
+
+  switch (operation) {
+  case WORKLOAD_ADD:
+    return addNode(head, generateHousehold(rng));
+  case WORKLOAD_DELETE:
+    deleteLinkedListItem(head, regionNumber, generateTown(rng),
+                         generateRace(rng));
+    break;
+  case WORKLOAD_FILTER:
+    countLinkedListByRegionWithMinTestedPositive(
+        regionNumber, (int)boundedRandom(rng, 10) + 1);
+    break;
+  case WORKLOAD_COUNT:
+    countHouseholdsByRegionAndRaces(regionNumber, 1u << generateRace(rng));
+    break;
+  default:
+    rankPositiveTestedBasedOnRegion(*head, region);
+    sortCaseRanking(region, NUM_REGIONS);
+    rankPositiveTestedBasedOnTown(*head, town);
+    sortCaseRanking(town, NUM_TOWNS);
+    break;
+  }
+  return 1;
+}
+
+/**
+ * Replay a workload against the linked list, then print the throughput and
+ * the latency percentiles of every kind of operation
+ *
+ * @param head
+ * @param workload
+ * @param seed seed of the operations and their arrivals
+ */
+void runWorkload(NodePtr *head, const workload_options *workload,
+                 uint64_t seed) {
+  latency_histogram *histograms;
+  struct timespec start, arrival, finish;
+  random_context rng;
+  unsigned total = 0;
+  long done;
+  double seconds;
+  int i;
+
+  histograms = calloc(WORKLOAD_OPERATIONS, sizeof(*histograms));
+  if (histograms == NULL) {
+    printf("Not enough memory to run the workload.\n");
+    return;
+  }
+  for (i = 0; i < WORKLOAD_OPERATIONS; i++)
+    total += workload->weights[i];
+  seedRandom(&rng, ~seed);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  arrival = start;
+  for (done = 0; done < workload->operations; done++) {
+    struct timespec end;
+    unsigned pick = boundedRandom(&rng, total);
+    int operation = 0;
+
+    // pick the kind of operation from the weights of the mix
+    while (pick >= workload->weights[operation])
+      pick -= workload->weights[operation++];
+
+    // open loop -- wait for the arrival of the operation, unless running late
+    if (workload->rate > 0) {
+      // exponential gap between arrivals, from a uniform number in (0, 1]
+      double uniform = ((nextRandom(&rng) >> 11) + 1) / 9007199254740992.0;
+      addNanoseconds(&arrival, (long)(-log(uniform) / workload->rate * 1e9));
+      waitUntil(&arrival);
+    } else {
+      clock_gettime(CLOCK_MONOTONIC, &arrival);
+    }
+
+    if (!runOperation(head, operation, &rng)) {
+      printf("Not enough memory to add a household, the workload stopped.\n");
+      break;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    recordLatency(&histograms[operation], nanosecondsBetween(&arrival, &end));
+  }
+  clock_gettime(CLOCK_MONOTONIC, &finish);
+  seconds = nanosecondsBetween(&start, &finish) / 1e9;
+
+  printf("\nWorkload: %ld operations in %.2f s (%.0f operations/s), %ld "
+         "households left\n",
+         done, seconds, seconds > 0 ? done / seconds : 0.0,
+         getNodePoolStats().nodesInUse);
+  printf("%10s\t%10s\t%12s\t%10s\t%10s\t%10s\t%10s\t%10s\n", "Operation",
+         "Count", "Operations/s", "Mean us", "p50 us", "p99 us", "p99.9 us",
+         "Max us");
+  for (i = 0; i < WORKLOAD_OPERATIONS; i++) {
+    const latency_histogram *histogram = &histograms[i];
+    if (histogram->operations == 0)
+      continue;
+    printf("%10s\t%10ld\t%12.0f\t%10.1f\t%10.1f\t%10.1f\t%10.1f\t%10.1f\n",
+           operationNames[i], histogram->operations,
+           seconds > 0 ? histogram->operations / seconds : 0.0,
+           histogram->total / histogram->operations / 1e3,
+           latencyPercentile(histogram, 50) / 1e3,
+           latencyPercentile(histogram, 99) / 1e3,
+           latencyPercentile(histogram, 99.9) / 1e3, histogram->max / 1e3);
+  }
+  puts("");
+  free(histograms);
+}
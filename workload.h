@@ -0,0 +1,39 @@
+/**
+ * @author Elmer Almeida
+ * @date October 17 2026
+ *
+ * This file handles the definitions of the workload driver. A mix of adds,
+ * triplet deletes, filters, counts and rankings is replayed against the linked
+ * list and its indexes at a given arrival rate, and the throughput and latency
+ * of every kind of operation are reported.
+ */
+
+#ifndef ELMERALMEIDAASSIGN3_WORKLOAD_H
+#define ELMERALMEIDAASSIGN3_WORKLOAD_H
+
+#include <stdint.h>
+
+#include "almeielm.h"
+
+// kinds of operations of a workload
+#define WORKLOAD_ADD 0    // add a household, like addRecord
+#define WORKLOAD_DELETE 1 // delete a triplet, like deleteByRegionTownRace
+#define WORKLOAD_FILTER 2 // households of a region with a minimum positive
+#define WORKLOAD_COUNT 3  // households of a region and race, from the bitmaps
+#define WORKLOAD_RANK 4   // region and town rankings
+#define WORKLOAD_OPERATIONS 5
+
+#define DEFAULT_WORKLOAD_OPERATIONS 100000L
+
+typedef struct workload_options {
+  unsigned weights[WORKLOAD_OPERATIONS]; // share of every kind of operation
+  long operations; // number of operations to run
+  double rate;     // operations started per second, 0 for as fast as possible
+} workload_options;
+
+void initWorkloadOptions(workload_options *workload);
+int parseWorkloadMix(const char *mix, workload_options *workload);
+void runWorkload(NodePtr *head, const workload_options *workload,
+                 uint64_t seed);
+
+#endif // ELMERALMEIDAASSIGN3_WORKLOAD_H